@@ -8,8 +8,25 @@
 
 #import "AppDelegate.h"
 #import <FeedMedia/FeedMedia.h>
-
-@interface AppDelegate () <FMStationDownloadDelegate>
+#import "OfflineSyncQueue.h"
+#import "OfflineDownloadPlanner.h"
+#import "OfflineStorageBudget.h"
+#import "OfflineLoudnessAnalyzer.h"
+#import "PlaybackLatencyMonitor.h"
+#import "PlayHistoryLog.h"
+
+// minutes of music to keep offline for each station
+static const double kOfflineTargetMinutes = 30.0;
+
+@interface AppDelegate () <OfflineSyncQueueDelegate>
+
+@property (strong, nonatomic) OfflineSyncQueue *syncQueue;
+@property (strong, nonatomic) OfflineSyncJournal *syncJournal;
+@property (strong, nonatomic) OfflineStorageBudget *storageBudget;
+@property (strong, nonatomic) OfflineLoudnessAnalyzer *loudnessAnalyzer;
+@property (strong, nonatomic) PlaybackLatencyMonitor *latencyMonitor;
+@property (strong, nonatomic) PlayHistoryLog *playHistoryLog;
+@property (nonatomic) BOOL startedPlayback;
 
 @end
 
@@ -20,26 +37,74 @@
     // initialize feed.fm and pull in list of remote offline stations
     [FMAudioPlayer setClientToken:@"offline" secret:@"offline"];
     
+    // find out what downloads the last run of the app left unfinished
+    self.syncJournal = [[OfflineSyncJournal alloc] initWithURL:[OfflineSyncJournal defaultJournalURL]];
+    
+    // keep downloaded music under 500MB, dropping the least recently played stations first
+    self.storageBudget = [[OfflineStorageBudget alloc] initWithPlayer:[FMAudioPlayer sharedPlayer] recencyURL:[OfflineStorageBudget defaultRecencyURL]];
+    self.storageBudget.budgetBytes = 500LL * 1024 * 1024;
+    
+    // level downloaded songs the server sent no loudness for, measuring each one once
+    self.loudnessAnalyzer = [[OfflineLoudnessAnalyzer alloc] initWithResultsURL:[OfflineLoudnessAnalyzer defaultResultsURL]];
+    
+    // log how long it takes from asking for music to hearing it
+    self.latencyMonitor = [[PlaybackLatencyMonitor alloc] initWithPlayer:[FMAudioPlayer sharedPlayer]];
+    
+    // keep playHistory to the last 50 songs, with older plays logged to disk
+    self.playHistoryLog = [[PlayHistoryLog alloc] initWithPlayer:[FMAudioPlayer sharedPlayer] logURL:[PlayHistoryLog defaultLogURL]];
+    
     [[FMAudioPlayer sharedPlayer] whenAvailable:^{
         // streaming stations are available here, as is the list of downloadable stations
         FMAudioPlayer *player = [FMAudioPlayer sharedPlayer];
         
-        // list out stations available for download
+        [self.loudnessAnalyzer applyToStations:player.localOfflineStationList];
+        
+        // list out stations available for download, with a rough idea of
+        // what the download we're about to ask for will cost, and leave out
+        // any that wouldn't fit in the storage budget alongside the others,
+        // rather than download them only to delete them again
+        NSMutableArray<FMStation *> *stations = [NSMutableArray array];
+        long long plannedBytes = 0;
+        
         for (FMStation *station in player.remoteOfflineStationList) {
-            NSLog(@"offline station: %@", station.name);
+            FMStation *localStation = [player.localOfflineStationList getStationWithName:station.name];
+            OfflineDownloadPlan *plan = [OfflineDownloadPlanner planForStation:station targetMinutes:kOfflineTargetMinutes localStation:localStation];
+
+            NSLog(@"offline station: %@ %@", station.name, plan ?: @"");
+            
+            if (![self.storageBudget hasRoomForBytes:plannedBytes + plan.bytes]) {
+                NSLog(@"not syncing station %@, it would put offline storage over budget", station.name);
+                continue;
+            }
+            
+            plannedBytes += plan.bytes;
+            [stations addObject:station];
         }
         
-        // download/update the first available offline station
-        FMStation *station = player.remoteOfflineStationList[0];
-        [player downloadAndSyncStation:station withDelegate:self];
+        // download/update all the available offline stations, a couple at a time
+        self.syncQueue = [[OfflineSyncQueue alloc] initWithPlayer:player];
+        self.syncQueue.delegate = self;
+        self.syncQueue.journal = self.syncJournal;
+        self.syncQueue.concurrencyController = [[OfflineSyncConcurrencyController alloc] initWithInitialLimit:self.syncQueue.maxConcurrentDownloads];
+        
+        // anything a previous run didn't finish goes first
+        [self.syncQueue enqueueInterruptedStations:stations];
+        
+        // ask for the same amount of music the plans above were made for
+        for (FMStation *station in stations) {
+            [self.syncQueue enqueueStation:station forTargetMinutes:@(kOfflineTargetMinutes)];
+        }
         
     } notAvailable:^{
         // couldn't contact feed.fm - we must be offline!
         FMAudioPlayer *player = [FMAudioPlayer sharedPlayer];
         
+        [self.loudnessAnalyzer applyToStations:player.localOfflineStationList];
+        
         // play the first station we've downloaded
         if (player.localOfflineStationList.count > 0) {
             player.activeStation = player.localOfflineStationList[0];
+            [self.latencyMonitor noteStartRequested];
             [player play];
         }
     }];
@@ -48,15 +113,41 @@
 }
 
 
-- (void)stationDownloadComplete:(FMStation *)station {
+- (void)syncQueue:(OfflineSyncQueue *)queue didCompleteStation:(FMStation *)station failedCount:(int)failedCount {
     FMAudioPlayer *player = [FMAudioPlayer sharedPlayer];
 
-    player.activeStation = station;
-    [player play];
+    if (failedCount > 0) {
+        NSLog(@"Station %@ finished downloading with %d failed files", station.name, failedCount);
+    }
+
+    // start playback with the first station that finishes
+    if (!self.startedPlayback) {
+        self.startedPlayback = YES;
+        player.activeStation = station;
+        [self.latencyMonitor noteStartRequested];
+        [player play];
+    }
+
+    // make room if needed, without touching anything still downloading
+    // or the station that just arrived
+    NSMutableSet<NSString *> *protectedNames = [queue.queuedStationNames mutableCopy];
+    if (station.name != nil) {
+        [protectedNames addObject:station.name];
+    }
+
+    [self.storageBudget enforceBudgetProtectingStationNames:protectedNames];
+
+    // measure any new songs that came without loudness information
+    [self.loudnessAnalyzer analyzeStation:[player.localOfflineStationList getStationWithName:station.name] ?: station];
 }
 
-- (void)stationDownloadProgress:(FMStation *)station pendingCount:(int)pendingCount failedCount:(int)failedCount totalCount:(int)totalCount {
-    NSLog(@"Station download in progress.. %d of %d files remaining to download", pendingCount, totalCount);
+- (void)syncQueue:(OfflineSyncQueue *)queue didUpdateProgress:(OfflineDownloadProgress *)progress {
+    NSLog(@"Station %@ download in progress.. %.1f of %.1f MB at %.0f KB/s, %.0f seconds remaining",
+          progress.station.name,
+          progress.bytesDownloaded / (1024.0 * 1024.0),
+          progress.bytesTotal / (1024.0 * 1024.0),
+          progress.bytesPerSecond / 1024.0,
+          progress.estimatedSecondsRemaining);
 }
 
 
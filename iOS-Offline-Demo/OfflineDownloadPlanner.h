@@ -0,0 +1,88 @@
+//
+//  OfflineDownloadPlanner.h
+//  iOS-Offline-Demo
+//
+//  Copyright © 2026 Feed Media. All rights reserved.
+//
+
+#import <Foundation/Foundation.h>
+#import <FeedMedia/FeedMedia.h>
+
+/**
+ The result of `[OfflineDownloadPlanner planForStation:targetMinutes:localStation:]`.
+ */
+
+@interface OfflineDownloadPlan : NSObject
+
+/**
+ * Items that would need to be downloaded, in station order.
+ */
+
+@property (nonatomic, readonly) NSArray<FMAudioItem *> *items;
+
+/**
+ * Estimated number of bytes to download.
+ */
+
+@property (nonatomic, readonly) long long bytes;
+
+/**
+ * Seconds of music in `items`.
+ */
+
+@property (nonatomic, readonly) NSTimeInterval downloadSeconds;
+
+/**
+ * Seconds of music the station would have on the device once
+ * `items` are downloaded, counting what is already there.
+ */
+
+@property (nonatomic, readonly) NSTimeInterval totalSeconds;
+
+/**
+ * NO if the station doesn't hold enough music to reach the target.
+ * When no smaller set reaches the target, `items` is everything not
+ * yet on the device.
+ */
+
+@property (nonatomic, readonly) BOOL meetsTarget;
+
+@end
+
+/**
+ Estimates what it would cost to have a given number of minutes
+ of a station available offline, so the app can warn before
+ starting a download on a metered connection.
+
+ The planner picks the set of not-yet-downloaded items that reaches
+ the target with the fewest bytes, using the `duration` and `bitrate`
+ of every `FMAudioItem` in the station. Items already in the local
+ copy of the station count toward the target for free.
+
+ The server still makes the final choice of songs in
+ `downloadAndSyncStation:forTargetMinutes:withDelegate:`, so the plan
+ is an estimate of the smallest download that would do the job.
+ */
+
+@interface OfflineDownloadPlanner : NSObject
+
+/**
+ * Estimated size of an item's audio file, from its duration and bitrate.
+ */
+
++ (long long) estimatedBytesForItem:(FMAudioItem *)item;
+
+/**
+ * Plan a download of the station.
+ *
+ * @param station a station from remoteOfflineStationList
+ * @param minutes minutes of music wanted offline
+ * @param localStation the station's entry in localOfflineStationList, or nil
+ * @return a plan, or nil if the station doesn't list its audio items
+ */
+
++ (OfflineDownloadPlan *) planForStation:(FMStation *)station
+                           targetMinutes:(double)minutes
+                            localStation:(FMStation *)localStation;
+
+@end
@@ -0,0 +1,171 @@
+//
+//  OfflineDownloadPlanner.m
+//  iOS-Offline-Demo
+//
+//  Copyright © 2026 Feed Media. All rights reserved.
+//
+
+#import "OfflineDownloadPlanner.h"
+
+// The solver table is (items x duration buckets), so durations are
+// bucketed to keep it small for long targets.
+#define kMaxDurationBuckets 2048
+
+@interface OfflineDownloadPlan ()
+
+@property (nonatomic, readwrite) NSArray<FMAudioItem *> *items;
+@property (nonatomic, readwrite) long long bytes;
+@property (nonatomic, readwrite) NSTimeInterval downloadSeconds;
+@property (nonatomic, readwrite) NSTimeInterval totalSeconds;
+@property (nonatomic, readwrite) BOOL meetsTarget;
+
+@end
+
+@implementation OfflineDownloadPlan
+
+- (NSString *) description {
+    return [NSString stringWithFormat:@"<OfflineDownloadPlan %lu items, %.1f MB, %.1f of %.1f minutes%@>",
+            (unsigned long) _items.count, _bytes / (1024.0 * 1024.0), _downloadSeconds / 60.0, _totalSeconds / 60.0,
+            _meetsTarget ? @"" : @", short of target"];
+}
+
+@end
+
+@implementation OfflineDownloadPlanner
+
++ (long long) estimatedBytesForItem:(FMAudioItem *)item {
+    // bitrate is in kbps
+    return (long long) (item.duration * item.bitrate * 1000.0 / 8.0);
+}
+
++ (OfflineDownloadPlan *) planForStation:(FMStation *)station
+                           targetMinutes:(double)minutes
+                            localStation:(FMStation *)localStation {
+    if (station.audioItems == nil) {
+        return nil;
+    }
+
+    NSMutableSet *localIds = [NSMutableSet set];
+    NSTimeInterval localSeconds = 0.0;
+
+    for (FMAudioItem *item in localStation.audioItems) {
+        if ((item.id != nil) && ![localIds containsObject:item.id]) {
+            [localIds addObject:item.id];
+            localSeconds += item.duration;
+        }
+    }
+
+    NSMutableArray<FMAudioItem *> *candidates = [NSMutableArray array];
+    for (FMAudioItem *item in station.audioItems) {
+        if ((item.id == nil) || ![localIds containsObject:item.id]) {
+            [candidates addObject:item];
+        }
+    }
+
+    NSTimeInterval needed = minutes * 60.0 - localSeconds;
+
+    OfflineDownloadPlan *plan = [[OfflineDownloadPlan alloc] init];
+
+    if (needed <= 0.0) {
+        plan.items = @[];
+        plan.totalSeconds = localSeconds;
+        plan.meetsTarget = YES;
+        return plan;
+    }
+
+    NSArray *chosen = [self cheapestItemsFrom:candidates coveringSeconds:needed];
+
+    if (chosen == nil) {
+        // the solver rounds durations down, so it can miss a target the
+        // real durations reach; everything is the best we can do either way
+        chosen = candidates;
+    }
+
+    long long bytes = 0;
+    NSTimeInterval seconds = 0.0;
+    for (FMAudioItem *item in chosen) {
+        bytes += [self estimatedBytesForItem:item];
+        seconds += item.duration;
+    }
+
+    plan.meetsTarget = (seconds >= needed);
+    plan.items = chosen;
+    plan.bytes = bytes;
+    plan.downloadSeconds = seconds;
+    plan.totalSeconds = localSeconds + seconds;
+
+    return plan;
+}
+
+// 0/1 covering knapsack: the subset of items with total duration of at least
+// 'seconds' that has the smallest total size. Returns nil if no subset covers.
++ (NSArray<FMAudioItem *> *) cheapestItemsFrom:(NSArray<FMAudioItem *> *)items coveringSeconds:(NSTimeInterval)seconds {
+    NSUInteger n = items.count;
+
+    NSTimeInterval bucketSeconds = MAX(1.0, ceil(seconds / kMaxDurationBuckets));
+    int target = (int) ceil(seconds / bucketSeconds);
+
+    // best[c] = fewest bytes that cover c buckets (c == target means 'target or more')
+    long long *best = malloc(sizeof(long long) * (target + 1));
+    // from[i * (target + 1) + c] = bucket we came from when item i improved best[c], or -1
+    int *from = malloc(sizeof(int) * n * (target + 1));
+
+    best[0] = 0;
+    for (int c = 1; c <= target; c++) {
+        best[c] = LLONG_MAX;
+    }
+
+    for (NSUInteger i = 0; i < n; i++) {
+        FMAudioItem *item = items[i];
+        int *fromRow = from + i * (target + 1);
+
+        for (int c = 0; c <= target; c++) {
+            fromRow[c] = -1;
+        }
+
+        // round down, so the chosen set is never short of the target
+        int buckets = (int) floor(item.duration / bucketSeconds);
+        if (buckets <= 0) {
+            continue;
+        }
+
+        long long bytes = [self estimatedBytesForItem:item];
+
+        // walk downward so each item is used at most once
+        for (int c = target; c >= 0; c--) {
+            if (best[c] == LLONG_MAX) {
+                continue;
+            }
+
+            int next = MIN(target, c + buckets);
+            if (best[c] + bytes < best[next]) {
+                best[next] = best[c] + bytes;
+                fromRow[next] = c;
+            }
+        }
+    }
+
+    NSMutableArray *chosen = nil;
+
+    if (best[target] != LLONG_MAX) {
+        NSMutableIndexSet *indexes = [NSMutableIndexSet indexSet];
+        int c = target;
+
+        for (NSInteger i = n - 1; (i >= 0) && (c > 0); i--) {
+            int prev = from[i * (target + 1) + c];
+            if (prev >= 0) {
+                [indexes addIndex:i];
+                c = prev;
+            }
+        }
+
+        chosen = [[items objectsAtIndexes:indexes] mutableCopy];
+    }
+
+    free(best);
+    free(from);
+
+    return chosen;
+}
+
+@end
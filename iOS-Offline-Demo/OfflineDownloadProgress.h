@@ -0,0 +1,90 @@
+//
+//  OfflineDownloadProgress.h
+//  iOS-Offline-Demo
+//
+//  Copyright © 2026 Feed Media. All rights reserved.
+//
+
+#import <Foundation/Foundation.h>
+#import <FeedMedia/FeedMedia.h>
+
+/**
+ Byte-level view of a station download, built up from the per-file
+ counts the SDK reports to `FMStationDownloadDelegate`.
+
+ The SDK doesn't report file sizes, so each file is assumed to be the
+ average estimated size of the station's `audioItems` (from their
+ duration and bitrate). When the station doesn't list its items, a
+ nominal song length at the player's `maxBitrate` is used instead.
+
+ Throughput is smoothed with an exponentially weighted moving average,
+ so the remaining-time estimate doesn't jump with every file.
+ */
+
+@interface OfflineDownloadProgress : NSObject
+
+@property (nonatomic, readonly) FMStation *station;
+
+@property (nonatomic, readonly) int filesTotal;
+@property (nonatomic, readonly) int filesCompleted;
+@property (nonatomic, readonly) int filesFailed;
+
+/**
+ * Estimated bytes in the files that have finished downloading.
+ */
+
+@property (nonatomic, readonly) long long bytesDownloaded;
+
+/**
+ * Estimated bytes in all the files being downloaded.
+ */
+
+@property (nonatomic, readonly) long long bytesTotal;
+
+/**
+ * Smoothed download rate, in bytes per second, or 0 until the first
+ * file has finished.
+ */
+
+@property (nonatomic, readonly) double bytesPerSecond;
+
+/**
+ * Estimated seconds until the download finishes, or -1 when there
+ * isn't enough data for an estimate yet.
+ */
+
+@property (nonatomic, readonly) NSTimeInterval estimatedSecondsRemaining;
+
+/**
+ * Fraction of the files that are either downloaded or failed, 0.0 to 1.0.
+ */
+
+@property (nonatomic, readonly) double fractionCompleted;
+
+/**
+ * YES once no files are left pending.
+ */
+
+@property (nonatomic, readonly) BOOL isFinished;
+
+/**
+ * Weight given to the newest throughput sample. Defaults to 0.3.
+ */
+
+@property (nonatomic) double smoothingFactor;
+
+- (instancetype) initWithStation:(FMStation *)station player:(FMAudioPlayer *)player;
+
+/**
+ * Start counting again for a new download attempt.
+ */
+
+- (void) reset;
+
+/**
+ * Feed in the values from `stationDownloadProgress:pendingCount:failedCount:totalCount:`.
+ */
+
+- (void) updateWithPendingCount:(int)pendingCount failedCount:(int)failedCount totalCount:(int)totalCount;
+
+@end
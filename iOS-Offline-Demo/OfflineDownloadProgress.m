@@ -0,0 +1,124 @@
+//
+//  OfflineDownloadProgress.m
+//  iOS-Offline-Demo
+//
+//  Copyright © 2026 Feed Media. All rights reserved.
+//
+
+#import "OfflineDownloadProgress.h"
+#import "OfflineDownloadPlanner.h"
+
+// used to size files when the station doesn't list its items
+#define kNominalSongSeconds 210.0
+
+@implementation OfflineDownloadProgress {
+
+    long long _bytesPerFile;
+
+    NSTimeInterval _lastSampleTime;
+    long long _lastSampleBytes;
+}
+
+- (instancetype) initWithStation:(FMStation *)station player:(FMAudioPlayer *)player {
+    if (self = [super init]) {
+        _station = station;
+        _smoothingFactor = 0.3;
+        _bytesPerFile = [self averageBytesPerFileInStation:station player:player];
+
+        [self reset];
+    }
+
+    return self;
+}
+
+- (long long) averageBytesPerFileInStation:(FMStation *)station player:(FMAudioPlayer *)player {
+    long long bytes = 0;
+    NSUInteger count = 0;
+
+    for (FMAudioItem *item in station.audioItems) {
+        long long itemBytes = [OfflineDownloadPlanner estimatedBytesForItem:item];
+
+        if (itemBytes > 0) {
+            bytes += itemBytes;
+            count++;
+        }
+    }
+
+    if (count > 0) {
+        return bytes / count;
+    }
+
+    // maxBitrate of 0 means 'highest available', so assume 128kbps for that
+    NSInteger kbps = (player.maxBitrate > 0) ? player.maxBitrate : 128;
+
+    return (long long) (kNominalSongSeconds * kbps * 1000.0 / 8.0);
+}
+
+- (void) reset {
+    _filesTotal = 0;
+    _filesCompleted = 0;
+    _filesFailed = 0;
+    _bytesPerSecond = 0.0;
+    _isFinished = NO;
+
+    _lastSampleTime = [NSDate timeIntervalSinceReferenceDate];
+    _lastSampleBytes = 0;
+}
+
+- (long long) bytesDownloaded {
+    return _filesCompleted * _bytesPerFile;
+}
+
+- (long long) bytesTotal {
+    return _filesTotal * _bytesPerFile;
+}
+
+- (double) fractionCompleted {
+    if (_filesTotal == 0) {
+        return _isFinished ? 1.0 : 0.0;
+    }
+
+    return (double) (_filesCompleted + _filesFailed) / _filesTotal;
+}
+
+- (NSTimeInterval) estimatedSecondsRemaining {
+    if (_isFinished) {
+        return 0.0;
+    }
+
+    if (_bytesPerSecond <= 0.0) {
+        return -1.0;
+    }
+
+    int remainingFiles = _filesTotal - _filesCompleted - _filesFailed;
+
+    return (remainingFiles * _bytesPerFile) / _bytesPerSecond;
+}
+
+- (void) updateWithPendingCount:(int)pendingCount failedCount:(int)failedCount totalCount:(int)totalCount {
+    _filesTotal = totalCount;
+    _filesFailed = failedCount;
+    _filesCompleted = MAX(0, totalCount - pendingCount - failedCount);
+    _isFinished = (pendingCount == 0);
+
+    long long bytes = self.bytesDownloaded;
+    if (bytes <= _lastSampleBytes) {
+        // nothing new arrived (start of download, or a failed file)
+        return;
+    }
+
+    NSTimeInterval now = [NSDate timeIntervalSinceReferenceDate];
+    NSTimeInterval elapsed = MAX(0.001, now - _lastSampleTime);
+    double rate = (bytes - _lastSampleBytes) / elapsed;
+
+    if (_bytesPerSecond <= 0.0) {
+        _bytesPerSecond = rate;
+    } else {
+        _bytesPerSecond = _smoothingFactor * rate + (1.0 - _smoothingFactor) * _bytesPerSecond;
+    }
+
+    _lastSampleTime = now;
+    _lastSampleBytes = bytes;
+}
+
+@end
@@ -0,0 +1,81 @@
+//
+//  OfflineLoudnessAnalyzer.h
+//  iOS-Offline-Demo
+//
+//  Copyright © 2026 Feed Media. All rights reserved.
+//
+
+#import <Foundation/Foundation.h>
+#import <FeedMedia/FeedMedia.h>
+
+/**
+ Measures the loudness of downloaded songs that came from the server
+ without a `replayGain`, so they can be levelled with the rest.
+
+ Call `analyzeStation:` once a station has finished syncing. Every song
+ in it that has no `replayGain`, and whose `contentUrl` is a local file,
+ is decoded once on a background queue and measured the EBU R128 way:
+ K-weighted, gated integrated loudness (ITU-R BS.1770-4) and sample
+ peak. Results are saved to disk by audio file `id`, so a song is never
+ analyzed twice.
+
+ `applyToStations:` turns those results into a `preGain` on each
+ matching `FMAudioItem`, taken to be in dB like `replayGain`. The gain
+ brings the song to `targetLoudness`, limited so that its peak doesn't
+ clip. Call it at launch on `localOfflineStationList`, so playback
+ gets the gain without analyzing anything.
+
+ The filtering and sums use Accelerate. After each station, the
+ analysis speed is logged as a realtime factor on one core.
+
+ All methods must be called from the main thread.
+ */
+
+@interface OfflineLoudnessAnalyzer : NSObject
+
+/**
+ * Loudness, in LUFS, that `applyToStations:` levels songs to.
+ * Defaults to -18, the ReplayGain 2.0 reference level.
+ */
+
+@property (nonatomic) double targetLoudness;
+
+/**
+ * Seconds of audio analyzed per second of analysis time so far, or 0
+ * if nothing has been analyzed yet. Analysis runs on a single queue,
+ * so this is per core.
+ */
+
+@property (nonatomic, readonly) double realtimeFactor;
+
++ (NSURL *) defaultResultsURL;
+
+- (instancetype) initWithResultsURL:(NSURL *)url;
+
+/**
+ * Analyze, in the background, every song in the station that needs
+ * it. The station's items get their `preGain` set as soon as the
+ * analysis finishes.
+ *
+ * @param station a station from localOfflineStationList
+ */
+
+- (void) analyzeStation:(FMStation *)station;
+
+/**
+ * Set `preGain` on every item in these stations that has no
+ * `replayGain` and has been analyzed.
+ *
+ * @return number of items whose `preGain` was set
+ */
+
+- (NSUInteger) applyToStations:(NSArray<FMStation *> *)stations;
+
+/**
+ * Integrated loudness, in LUFS, measured for the item, or NAN if it
+ * hasn't been analyzed.
+ */
+
+- (double) loudnessForItem:(FMAudioItem *)item;
+
+@end
@@ -0,0 +1,466 @@
+//
+//  OfflineLoudnessAnalyzer.m
+//  iOS-Offline-Demo
+//
+//  Copyright © 2026 Feed Media. All rights reserved.
+//
+
+#import "OfflineLoudnessAnalyzer.h"
+#import <AVFoundation/AVFoundation.h>
+#import <Accelerate/Accelerate.h>
+
+static NSString *const kLoudnessKey = @"loudness";
+static NSString *const kPeakKey = @"peak";
+
+// BS.1770 gating blocks are 400ms long and overlap by 75%, so they're
+// built from 100ms sub-blocks
+#define kSubBlockSeconds 0.1
+#define kSubBlocksPerBlock 4
+
+#define kAbsoluteGateLUFS -70.0
+#define kRelativeGateLU -10.0
+
+// two biquad sections: the high shelf, then the high pass
+#define kKWeightingSections 2
+
+/**
+ Running BS.1770 loudness measurement of one song, fed interleaved
+ float samples as they are decoded. Only the mean square of each
+ 100ms sub-block is kept, so memory stays small for long songs.
+ */
+
+@interface OfflineLoudnessMeter : NSObject
+
+@property (nonatomic, readonly) NSUInteger channels;
+@property (nonatomic, readonly) float peak;
+@property (nonatomic, readonly) NSTimeInterval seconds;
+
+- (instancetype) initWithSampleRate:(double)rate channels:(NSUInteger)channels;
+
+- (void) addInterleavedSamples:(const float *)samples frames:(NSUInteger)frames;
+
+/**
+ * Gated integrated loudness in LUFS, or NAN if the song is too short
+ * or too quiet to measure.
+ */
+
+- (double) integratedLoudness;
+
+@end
+
+@implementation OfflineLoudnessMeter {
+
+    double _rate;
+    unsigned long long _frames;
+
+    vDSP_biquad_Setup _kWeighting;
+
+    // filter state, 2 * kKWeightingSections + 2 floats per channel
+    NSMutableData *_delays;
+
+    // K-weighted samples of the current chunk, one channel after another
+    NSMutableData *_filtered;
+
+    NSUInteger _subBlockFrames;
+    NSUInteger _subBlockFill;
+    double _subBlockSum;
+
+    // mean square of each finished sub-block, summed over channels
+    NSMutableData *_subBlocks;
+}
+
+- (instancetype) initWithSampleRate:(double)rate channels:(NSUInteger)channels {
+    if (self = [super init]) {
+        _rate = rate;
+        _channels = channels;
+        _subBlockFrames = MAX(1, (NSUInteger) round(rate * kSubBlockSeconds));
+        _delays = [NSMutableData dataWithLength:channels * (2 * kKWeightingSections + 2) * sizeof(float)];
+        _filtered = [NSMutableData data];
+        _subBlocks = [NSMutableData data];
+
+        double coefficients[5 * kKWeightingSections];
+        [OfflineLoudnessMeter kWeightingCoefficients:coefficients sampleRate:rate];
+        _kWeighting = vDSP_biquad_CreateSetup(coefficients, kKWeightingSections);
+    }
+
+    return self;
+}
+
+- (void) dealloc {
+    if (_kWeighting != NULL) {
+        vDSP_biquad_DestroySetup(_kWeighting);
+    }
+}
+
+// BS.1770 only lists coefficients for 48kHz, so derive them for any
+// rate from the analog prototypes, as libebur128 does. Each section is
+// b0, b1, b2, a1, a2, the layout vDSP_biquad expects.
+
++ (void) kWeightingCoefficients:(double *)c sampleRate:(double)rate {
+    double f0 = 1681.974450955533;
+    double gain = 3.999843853973347;
+    double q = 0.7071752369554196;
+
+    double k = tan(M_PI * f0 / rate);
+    double vh = pow(10.0, gain / 20.0);
+    double vb = pow(vh, 0.4996667741545416);
+    double a0 = 1.0 + k / q + k * k;
+
+    c[0] = (vh + vb * k / q + k * k) / a0;
+    c[1] = 2.0 * (k * k - vh) / a0;
+    c[2] = (vh - vb * k / q + k * k) / a0;
+    c[3] = 2.0 * (k * k - 1.0) / a0;
+    c[4] = (1.0 - k / q + k * k) / a0;
+
+    f0 = 38.13547087602444;
+    q = 0.5003270373238773;
+
+    k = tan(M_PI * f0 / rate);
+    a0 = 1.0 + k / q + k * k;
+
+    c[5] = 1.0;
+    c[6] = -2.0;
+    c[7] = 1.0;
+    c[8] = 2.0 * (k * k - 1.0) / a0;
+    c[9] = (1.0 - k / q + k * k) / a0;
+}
+
+- (void) addInterleavedSamples:(const float *)samples frames:(NSUInteger)frames {
+    if ((frames == 0) || (_kWeighting == NULL)) {
+        return;
+    }
+
+    NSUInteger channels = _channels;
+
+    float chunkPeak = 0.0f;
+    vDSP_maxmgv(samples, 1, &chunkPeak, frames * channels);
+    _peak = MAX(_peak, chunkPeak);
+
+    if (_filtered.length < frames * channels * sizeof(float)) {
+        _filtered.length = frames * channels * sizeof(float);
+    }
+
+    float *filtered = _filtered.mutableBytes;
+    float *delays = _delays.mutableBytes;
+
+    for (NSUInteger ch = 0; ch < channels; ch++) {
+        vDSP_biquad(_kWeighting, delays + ch * (2 * kKWeightingSections + 2), samples + ch, channels, filtered + ch * frames, 1, frames);
+    }
+
+    NSUInteger done = 0;
+
+    while (done < frames) {
+        NSUInteger n = MIN(frames - done, _subBlockFrames - _subBlockFill);
+
+        for (NSUInteger ch = 0; ch < channels; ch++) {
+            float squares = 0.0f;
+            vDSP_svesq(filtered + ch * frames + done, 1, &squares, n);
+            _subBlockSum += squares;
+        }
+
+        done += n;
+        _subBlockFill += n;
+
+        if (_subBlockFill == _subBlockFrames) {
+            double meanSquare = _subBlockSum / _subBlockFrames;
+            [_subBlocks appendBytes:&meanSquare length:sizeof(meanSquare)];
+
+            _subBlockFill = 0;
+            _subBlockSum = 0.0;
+        }
+    }
+
+    _frames += frames;
+}
+
+- (NSTimeInterval) seconds {
+    return (_rate > 0.0) ? (_frames / _rate) : 0.0;
+}
+
+- (double) integratedLoudness {
+    NSUInteger count = _subBlocks.length / sizeof(double);
+    if (count < kSubBlocksPerBlock) {
+        return NAN;
+    }
+
+    const double *subBlocks = _subBlocks.bytes;
+    NSUInteger blockCount = count - kSubBlocksPerBlock + 1;
+    NSMutableData *blockData = [NSMutableData dataWithLength:blockCount * sizeof(double)];
+    double *blocks = blockData.mutableBytes;
+
+    double absoluteGate = pow(10.0, (kAbsoluteGateLUFS + 0.691) / 10.0);
+    double sum = 0.0;
+    NSUInteger gated = 0;
+
+    for (NSUInteger i = 0; i < blockCount; i++) {
+        double block = 0.0;
+        for (NSUInteger j = 0; j < kSubBlocksPerBlock; j++) {
+            block += subBlocks[i + j];
+        }
+
+        blocks[i] = block / kSubBlocksPerBlock;
+
+        if (blocks[i] > absoluteGate) {
+            sum += blocks[i];
+            gated++;
+        }
+    }
+
+    if (gated == 0) {
+        return NAN;
+    }
+
+    double relativeGate = (sum / gated) * pow(10.0, kRelativeGateLU / 10.0);
+    sum = 0.0;
+    gated = 0;
+
+    for (NSUInteger i = 0; i < blockCount; i++) {
+        if ((blocks[i] > absoluteGate) && (blocks[i] > relativeGate)) {
+            sum += blocks[i];
+            gated++;
+        }
+    }
+
+    return -0.691 + 10.0 * log10(sum / gated);
+}
+
+@end
+
+@implementation OfflineLoudnessAnalyzer {
+
+    NSURL *_url;
+
+    // audio file id -> loudness and peak
+    NSMutableDictionary<NSString *, NSDictionary *> *_results;
+
+    // audio file ids being analyzed, or that failed to analyze this session
+    NSMutableSet<NSString *> *_attempted;
+
+    NSTimeInterval _analyzedSeconds;
+    NSTimeInterval _analysisSeconds;
+
+    dispatch_queue_t _analysisQueue;
+    dispatch_queue_t _writeQueue;
+}
+
++ (NSURL *) defaultResultsURL {
+    NSURL *dir = [[NSFileManager defaultManager] URLsForDirectory:NSApplicationSupportDirectory inDomains:NSUserDomainMask].firstObject;
+
+    return [dir URLByAppendingPathComponent:@"offline-loudness.plist"];
+}
+
+- (instancetype) initWithResultsURL:(NSURL *)url {
+    if (self = [super init]) {
+        _url = url;
+        _targetLoudness = -18.0;
+        _results = [NSMutableDictionary dictionary];
+        _attempted = [NSMutableSet set];
+        _analysisQueue = dispatch_queue_create("fm.offline.loudness", dispatch_queue_attr_make_with_qos_class(DISPATCH_QUEUE_SERIAL, QOS_CLASS_UTILITY, 0));
+        _writeQueue = dispatch_queue_create("fm.offline.loudness.write", DISPATCH_QUEUE_SERIAL);
+
+        NSDictionary *saved = [NSDictionary dictionaryWithContentsOfURL:url];
+        for (NSString *fileId in saved) {
+            if ([saved[fileId] isKindOfClass:[NSDictionary class]]) {
+                _results[fileId] = saved[fileId];
+            }
+        }
+    }
+
+    return self;
+}
+
+- (double) realtimeFactor {
+    return (_analysisSeconds > 0.0) ? (_analyzedSeconds / _analysisSeconds) : 0.0;
+}
+
+- (double) loudnessForItem:(FMAudioItem *)item {
+    NSDictionary *result = (item.id != nil) ? _results[item.id] : nil;
+
+    return (result != nil) ? [result[kLoudnessKey] doubleValue] : NAN;
+}
+
+- (void) analyzeStation:(FMStation *)station {
+    NSMutableArray<NSString *> *fileIds = [NSMutableArray array];
+    NSMutableArray<NSURL *> *urls = [NSMutableArray array];
+    NSUInteger notLocal = 0;
+
+    for (FMAudioItem *item in station.audioItems) {
+        if ((item.replayGain != 0.0) || (item.id == nil) || (_results[item.id] != nil) || [_attempted containsObject:item.id]) {
+            continue;
+        }
+
+        if (!item.contentUrl.isFileURL) {
+            notLocal++;
+            continue;
+        }
+
+        [_attempted addObject:item.id];
+        [fileIds addObject:item.id];
+        [urls addObject:item.contentUrl];
+    }
+
+    if (notLocal > 0) {
+        NSLog(@"**WARNING** %lu songs in station %@ need loudness analysis but have no local file", (unsigned long) notLocal, station.name);
+    }
+
+    if (fileIds.count == 0) {
+        return;
+    }
+
+    __weak OfflineLoudnessAnalyzer *weakSelf = self;
+    dispatch_async(_analysisQueue, ^{
+        NSMutableDictionary *measured = [NSMutableDictionary dictionary];
+        NSTimeInterval audioSeconds = 0.0;
+        NSTimeInterval start = [NSDate timeIntervalSinceReferenceDate];
+
+        for (NSUInteger i = 0; i < fileIds.count; i++) {
+            @autoreleasepool {
+                OfflineLoudnessMeter *meter = [OfflineLoudnessAnalyzer measureFileAtURL:urls[i]];
+                double loudness = (meter != nil) ? [meter integratedLoudness] : NAN;
+
+                if (isnan(loudness)) {
+                    NSLog(@"**WARNING** unable to measure loudness of %@", urls[i].lastPathComponent);
+                    continue;
+                }
+
+                audioSeconds += meter.seconds;
+                measured[fileIds[i]] = @{ kLoudnessKey: @(loudness), kPeakKey: @(meter.peak) };
+            }
+        }
+
+        NSTimeInterval elapsed = [NSDate timeIntervalSinceReferenceDate] - start;
+
+        dispatch_async(dispatch_get_main_queue(), ^{
+            [weakSelf finishAnalysisOfStation:station results:measured audioSeconds:audioSeconds elapsed:elapsed];
+        });
+    });
+}
+
+- (void) finishAnalysisOfStation:(FMStation *)station results:(NSDictionary *)measured audioSeconds:(NSTimeInterval)audioSeconds elapsed:(NSTimeInterval)elapsed {
+    [_results addEntriesFromDictionary:measured];
+
+    _analyzedSeconds += audioSeconds;
+    _analysisSeconds += elapsed;
+
+    NSLog(@"measured loudness of %lu songs in station %@ at %.0fx realtime on one core",
+          (unsigned long) measured.count, station.name, (elapsed > 0.0) ? (audioSeconds / elapsed) : 0.0);
+
+    if (measured.count == 0) {
+        return;
+    }
+
+    [self applyToStations:@[ station ]];
+
+    [self save];
+}
+
++ (OfflineLoudnessMeter *) measureFileAtURL:(NSURL *)url {
+    AVURLAsset *asset = [AVURLAsset URLAssetWithURL:url options:nil];
+    AVAssetTrack *track = [asset tracksWithMediaType:AVMediaTypeAudio].firstObject;
+    if (track == nil) {
+        return nil;
+    }
+
+    NSError *error = nil;
+    AVAssetReader *reader = [AVAssetReader assetReaderWithAsset:asset error:&error];
+    if (reader == nil) {
+        return nil;
+    }
+
+    NSDictionary *settings = @{
+        AVFormatIDKey: @(kAudioFormatLinearPCM),
+        AVLinearPCMBitDepthKey: @32,
+        AVLinearPCMIsFloatKey: @YES,
+        AVLinearPCMIsBigEndianKey: @NO,
+        AVLinearPCMIsNonInterleaved: @NO
+    };
+
+    AVAssetReaderTrackOutput *output = [AVAssetReaderTrackOutput assetReaderTrackOutputWithTrack:track outputSettings:settings];
+    output.alwaysCopiesSampleData = NO;
+    [reader addOutput:output];
+
+    if (![reader startReading]) {
+        return nil;
+    }
+
+    OfflineLoudnessMeter *meter = nil;
+    CMSampleBufferRef sample;
+
+    while ((sample = [output copyNextSampleBuffer]) != NULL) {
+        const AudioStreamBasicDescription *format = CMAudioFormatDescriptionGetStreamBasicDescription(CMSampleBufferGetFormatDescription(sample));
+
+        AudioBufferList list;
+        CMBlockBufferRef block = NULL;
+        OSStatus status = CMSampleBufferGetAudioBufferListWithRetainedBlockBuffer(sample, NULL, &list, sizeof(list), NULL, NULL,
+                                                                                   kCMSampleBufferFlag_AudioBufferList_Assure16ByteAlignment, &block);
+
+        if ((status == noErr) && (format != NULL) && (format->mChannelsPerFrame > 0)) {
+            if (meter == nil) {
+                meter = [[OfflineLoudnessMeter alloc] initWithSampleRate:format->mSampleRate channels:format->mChannelsPerFrame];
+            }
+
+            if (format->mChannelsPerFrame == meter.channels) {
+                NSUInteger frames = list.mBuffers[0].mDataByteSize / (sizeof(float) * meter.channels);
+                [meter addInterleavedSamples:list.mBuffers[0].mData frames:frames];
+            }
+        }
+
+        if (block != NULL) {
+            CFRelease(block);
+        }
+
+        CFRelease(sample);
+    }
+
+    if (reader.status != AVAssetReaderStatusCompleted) {
+        return nil;
+    }
+
+    return meter;
+}
+
+- (double) gainForResult:(NSDictionary *)result {
+    double gain = _targetLoudness - [result[kLoudnessKey] doubleValue];
+    double peak = [result[kPeakKey] doubleValue];
+
+    // don't boost a song so far that its loudest sample clips
+    if (peak > 0.0) {
+        gain = MIN(gain, -20.0 * log10(peak));
+    }
+
+    return gain;
+}
+
+- (NSUInteger) applyToStations:(NSArray<FMStation *> *)stations {
+    NSUInteger count = 0;
+
+    for (FMStation *station in stations) {
+        for (FMAudioItem *item in station.audioItems) {
+            NSDictionary *result = (item.id != nil) ? _results[item.id] : nil;
+
+            if ((item.replayGain != 0.0) || (result == nil)) {
+                continue;
+            }
+
+            item.preGain = [self gainForResult:result];
+            count++;
+        }
+    }
+
+    return count;
+}
+
+- (void) save {
+    NSDictionary *snapshot = [_results copy];
+    NSURL *url = _url;
+
+    dispatch_async(_writeQueue, ^{
+        [[NSFileManager defaultManager] createDirectoryAtURL:[url URLByDeletingLastPathComponent] withIntermediateDirectories:YES attributes:nil error:nil];
+
+        if (![snapshot writeToURL:url atomically:YES]) {
+            NSLog(@"**WARNING** unable to write loudness results to %@", url);
+        }
+    });
+}
+
+@end
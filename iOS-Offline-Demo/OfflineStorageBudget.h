@@ -0,0 +1,107 @@
+//
+//  OfflineStorageBudget.h
+//  iOS-Offline-Demo
+//
+//  Copyright © 2026 Feed Media. All rights reserved.
+//
+
+#import <Foundation/Foundation.h>
+#import <FeedMedia/FeedMedia.h>
+
+/**
+ Keeps the offline stations in `localOfflineStationList` under a
+ fixed amount of disk space.
+
+ The budget watches `FMAudioPlayerCurrentItemDidBeginPlaybackNotification`
+ to learn when each station last had a song start, and saves that to
+ disk so it survives app restarts. When `enforceBudget` finds the
+ stations using more than `budgetBytes`, it deletes whole stations
+ with `deleteOfflineStation:`, least recently used first, until the
+ total fits. A station counts as used when a song from it starts, and
+ a station that has never been played counts as used when it first
+ shows up in `localOfflineStationList`, so a fresh download isn't
+ deleted before the user has had a chance to hear it. The active
+ station, and any station the caller names as protected (such as
+ those still downloading), is never deleted.
+
+ To avoid downloading a station only to delete it again, check
+ `hasRoomForBytes:` with the estimated size of a download before
+ starting it.
+
+ Sizes are estimated from the duration and bitrate of each station's
+ `audioItems`, and cached per station identifier, so checking the
+ budget doesn't walk every item of every station each time.
+
+ All methods must be called from the main thread.
+ */
+
+@interface OfflineStorageBudget : NSObject
+
+/**
+ * Maximum number of bytes offline stations may use. 0, the default,
+ * means no limit.
+ */
+
+@property (nonatomic) long long budgetBytes;
+
+/**
+ * Estimated bytes used by all stations in `localOfflineStationList`.
+ */
+
+@property (nonatomic, readonly) long long totalBytes;
+
++ (NSURL *) defaultRecencyURL;
+
+- (instancetype) initWithPlayer:(FMAudioPlayer *)player recencyURL:(NSURL *)url;
+
+/**
+ * Estimated bytes used by a station in `localOfflineStationList`.
+ */
+
+- (long long) bytesForStation:(FMStation *)station;
+
+/**
+ * Estimated bytes used by a single downloaded item.
+ */
+
+- (long long) bytesForItem:(FMAudioItem *)item;
+
+/**
+ * When the station last had a song start playback, or nil if it
+ * never has.
+ */
+
+- (NSDate *) lastPlayedDateForStation:(FMStation *)station;
+
+/**
+ * YES if there is no budget, or if `bytes` more would still fit
+ * alongside the stations already in `localOfflineStationList`.
+ *
+ * @param bytes estimated size of downloads about to be started, such
+ *   as the sum of their `OfflineDownloadPlan` bytes
+ */
+
+- (BOOL) hasRoomForBytes:(long long)bytes;
+
+/**
+ * Delete least recently played stations until the total fits within
+ * `budgetBytes`, never touching the active station or any station
+ * named in `protectedNames`. Call this after a station download
+ * completes, once `activeStation` has been updated, and pass the
+ * names of stations that are still queued or downloading along with
+ * the one that just finished.
+ *
+ * @param protectedNames names of stations that must not be deleted, or nil
+ * @return the names of the stations that were deleted
+ */
+
+- (NSArray<NSString *> *) enforceBudgetProtectingStationNames:(NSSet<NSString *> *)protectedNames;
+
+/**
+ * Same as `enforceBudgetProtectingStationNames:` with only the active
+ * station protected.
+ */
+
+- (NSArray<NSString *> *) enforceBudget;
+
+@end
@@ -0,0 +1,229 @@
+//
+//  OfflineStorageBudget.m
+//  iOS-Offline-Demo
+//
+//  Copyright © 2026 Feed Media. All rights reserved.
+//
+
+#import "OfflineStorageBudget.h"
+#import "OfflineDownloadPlanner.h"
+
+static NSString *const kPlayedKey = @"played";
+static NSString *const kSeenKey = @"seen";
+
+@interface OfflineStationSize : NSObject
+
+@property (nonatomic, copy) NSString *identifier;
+@property (nonatomic) long long bytes;
+
+@end
+
+@implementation OfflineStationSize
+
+@end
+
+@implementation OfflineStorageBudget {
+
+    FMAudioPlayer *_player;
+    NSURL *_url;
+
+    // station name -> date a song in the station last started
+    NSMutableDictionary<NSString *, NSDate *> *_played;
+
+    // station name -> date the station first showed up locally
+    NSMutableDictionary<NSString *, NSDate *> *_seen;
+
+    // station name -> size as of the station identifier we last measured
+    NSMutableDictionary<NSString *, OfflineStationSize *> *_sizes;
+
+    dispatch_queue_t _writeQueue;
+}
+
++ (NSURL *) defaultRecencyURL {
+    NSURL *dir = [[NSFileManager defaultManager] URLsForDirectory:NSApplicationSupportDirectory inDomains:NSUserDomainMask].firstObject;
+
+    return [dir URLByAppendingPathComponent:@"offline-play-recency.plist"];
+}
+
+- (instancetype) initWithPlayer:(FMAudioPlayer *)player recencyURL:(NSURL *)url {
+    if (self = [super init]) {
+        _player = player;
+        _url = url;
+        _played = [NSMutableDictionary dictionary];
+        _seen = [NSMutableDictionary dictionary];
+        _sizes = [NSMutableDictionary dictionary];
+        _writeQueue = dispatch_queue_create("fm.offline.recency", DISPATCH_QUEUE_SERIAL);
+
+        NSDictionary *saved = [NSDictionary dictionaryWithContentsOfURL:url];
+        if ([saved[kPlayedKey] isKindOfClass:[NSDictionary class]]) {
+            [_played addEntriesFromDictionary:saved[kPlayedKey]];
+        }
+        if ([saved[kSeenKey] isKindOfClass:[NSDictionary class]]) {
+            [_seen addEntriesFromDictionary:saved[kSeenKey]];
+        }
+
+        [self recordNewLocalStations];
+
+        [[NSNotificationCenter defaultCenter] addObserver:self selector:@selector(itemStarted:) name:FMAudioPlayerCurrentItemDidBeginPlaybackNotification object:_player];
+    }
+
+    return self;
+}
+
+- (void) dealloc {
+    [[NSNotificationCenter defaultCenter] removeObserver:self];
+}
+
+- (void) itemStarted:(NSNotification *)notification {
+    NSString *name = _player.currentItem.station.name ?: _player.activeStation.name;
+
+    if (name == nil) {
+        return;
+    }
+
+    _played[name] = [NSDate date];
+
+    [self save];
+}
+
+- (long long) bytesForItem:(FMAudioItem *)item {
+    return [OfflineDownloadPlanner estimatedBytesForItem:item];
+}
+
+- (long long) bytesForStation:(FMStation *)station {
+    OfflineStationSize *size = _sizes[station.name];
+
+    // a station's identifier changes whenever its contents do
+    if ((size == nil) || ![size.identifier isEqualToString:station.identifier]) {
+        size = [[OfflineStationSize alloc] init];
+        size.identifier = station.identifier;
+
+        for (FMAudioItem *item in station.audioItems) {
+            size.bytes += [self bytesForItem:item];
+        }
+
+        _sizes[station.name] = size;
+    }
+
+    return size.bytes;
+}
+
+- (long long) totalBytes {
+    long long total = 0;
+
+    for (FMStation *station in _player.localOfflineStationList) {
+        total += [self bytesForStation:station];
+    }
+
+    return total;
+}
+
+- (NSDate *) lastPlayedDateForStation:(FMStation *)station {
+    return _played[station.name];
+}
+
+- (void) recordNewLocalStations {
+    BOOL changed = NO;
+
+    for (FMStation *station in _player.localOfflineStationList) {
+        if ((station.name != nil) && (_seen[station.name] == nil)) {
+            _seen[station.name] = [NSDate date];
+            changed = YES;
+        }
+    }
+
+    if (changed) {
+        [self save];
+    }
+}
+
+- (NSDate *) recencyForStation:(FMStation *)station {
+    return _played[station.name] ?: (_seen[station.name] ?: [NSDate date]);
+}
+
+- (BOOL) hasRoomForBytes:(long long)bytes {
+    return (_budgetBytes <= 0) || (self.totalBytes + bytes <= _budgetBytes);
+}
+
+- (NSArray<NSString *> *) enforceBudget {
+    return [self enforceBudgetProtectingStationNames:nil];
+}
+
+- (NSArray<NSString *> *) enforceBudgetProtectingStationNames:(NSSet<NSString *> *)protectedNames {
+    // catch stations that arrived since we last looked, before they're ranked
+    [self recordNewLocalStations];
+
+    if (_budgetBytes <= 0) {
+        return @[];
+    }
+
+    long long total = 0;
+    NSMutableArray<FMStation *> *candidates = [NSMutableArray array];
+    NSString *activeName = _player.activeStation.name;
+
+    for (FMStation *station in _player.localOfflineStationList) {
+        total += [self bytesForStation:station];
+
+        if (![station.name isEqualToString:activeName] && ![protectedNames containsObject:station.name]) {
+            [candidates addObject:station];
+        }
+    }
+
+    if (total <= _budgetBytes) {
+        return @[];
+    }
+
+    NSMutableDictionary<NSString *, NSDate *> *recency = [NSMutableDictionary dictionary];
+    for (FMStation *station in candidates) {
+        recency[station.name] = [self recencyForStation:station];
+    }
+
+    // least recently played first
+    [candidates sortUsingComparator:^NSComparisonResult(FMStation *a, FMStation *b) {
+        return [recency[a.name] compare:recency[b.name]];
+    }];
+
+    NSMutableArray *evicted = [NSMutableArray array];
+
+    for (FMStation *station in candidates) {
+        if (total <= _budgetBytes) {
+            break;
+        }
+
+        long long bytes = [self bytesForStation:station];
+        NSString *name = station.name;
+
+        NSLog(@"offline storage over budget (%lld > %lld bytes), deleting station %@", total, _budgetBytes, name);
+
+        [_player deleteOfflineStation:station];
+
+        total -= bytes;
+        [_sizes removeObjectForKey:name];
+        [_played removeObjectForKey:name];
+        [_seen removeObjectForKey:name];
+        [evicted addObject:name];
+    }
+
+    if (total > _budgetBytes) {
+        NSLog(@"**WARNING** offline storage still over budget after evicting everything but the active and protected stations");
+    }
+
+    [self save];
+
+    return evicted;
+}
+
+- (void) save {
+    NSDictionary *snapshot = @{ kPlayedKey: [_played copy], kSeenKey: [_seen copy] };
+    NSURL *url = _url;
+
+    dispatch_async(_writeQueue, ^{
+        [[NSFileManager defaultManager] createDirectoryAtURL:[url URLByDeletingLastPathComponent] withIntermediateDirectories:YES attributes:nil error:nil];
+
+        if (![snapshot writeToURL:url atomically:YES]) {
+            NSLog(@"**WARNING** unable to write play recency to %@", url);
+        }
+    });
+}
+
+@end
@@ -0,0 +1,69 @@
+//
+//  OfflineSyncConcurrencyController.h
+//  iOS-Offline-Demo
+//
+//  Copyright © 2026 Feed Media. All rights reserved.
+//
+
+#import <Foundation/Foundation.h>
+
+/**
+ Picks how many stations an `OfflineSyncQueue` downloads at once,
+ using additive-increase/multiplicative-decrease.
+
+ After every download attempt the queue reports the throughput the
+ station saw and whether any files failed. While each download keeps
+ getting about as much bandwidth as before, the limit grows by one.
+ When files fail, or per-download throughput falls well below its
+ running average (a sign the link is saturated), the limit is cut
+ by `decreaseFactor`.
+ */
+
+@interface OfflineSyncConcurrencyController : NSObject
+
+/**
+ * Current number of downloads to allow in flight.
+ */
+
+@property (nonatomic, readonly) NSUInteger limit;
+
+/**
+ * Lowest the limit will go. Defaults to 1, and is never less than 1.
+ * Raises `maxLimit` if set above it.
+ */
+
+@property (nonatomic) NSUInteger minLimit;
+
+/**
+ * Highest the limit will go. Defaults to 6, and is never less than
+ * `minLimit`.
+ */
+
+@property (nonatomic) NSUInteger maxLimit;
+
+/**
+ * The limit is multiplied by this on failure or congestion. Defaults to 0.5.
+ */
+
+@property (nonatomic) double decreaseFactor;
+
+/**
+ * Throughput below this fraction of the running average counts as
+ * congestion. Defaults to 0.7.
+ */
+
+@property (nonatomic) double congestionThreshold;
+
+- (instancetype) initWithInitialLimit:(NSUInteger)limit;
+
+/**
+ * Feed in the result of one station download attempt.
+ *
+ * @param bytesPerSecond smoothed throughput of the attempt, or 0 if unknown
+ * @param failedCount number of files that failed in the attempt
+ * @return the new limit
+ */
+
+- (NSUInteger) recordAttemptWithBytesPerSecond:(double)bytesPerSecond failedCount:(int)failedCount;
+
+@end
@@ -0,0 +1,66 @@
+//
+//  OfflineSyncConcurrencyController.m
+//  iOS-Offline-Demo
+//
+//  Copyright © 2026 Feed Media. All rights reserved.
+//
+
+#import "OfflineSyncConcurrencyController.h"
+
+// weight of the newest sample in the running throughput average
+#define kBaselineSmoothing 0.2
+
+@implementation OfflineSyncConcurrencyController {
+
+    double _baselineBytesPerSecond;
+}
+
+- (instancetype) initWithInitialLimit:(NSUInteger)limit {
+    if (self = [super init]) {
+        _minLimit = 1;
+        _maxLimit = 6;
+        _decreaseFactor = 0.5;
+        _congestionThreshold = 0.7;
+        _limit = MAX(_minLimit, MIN(_maxLimit, limit));
+    }
+
+    return self;
+}
+
+- (void) setMinLimit:(NSUInteger)minLimit {
+    _minLimit = MAX(1, minLimit);
+    _maxLimit = MAX(_minLimit, _maxLimit);
+    _limit = MAX(_minLimit, MIN(_maxLimit, _limit));
+}
+
+- (void) setMaxLimit:(NSUInteger)maxLimit {
+    _maxLimit = MAX(_minLimit, maxLimit);
+    _limit = MAX(_minLimit, MIN(_maxLimit, _limit));
+}
+
+- (NSUInteger) recordAttemptWithBytesPerSecond:(double)bytesPerSecond failedCount:(int)failedCount {
+    BOOL congested = (bytesPerSecond > 0.0) && (_baselineBytesPerSecond > 0.0) &&
+                     (bytesPerSecond < _baselineBytesPerSecond * _congestionThreshold);
+
+    if ((failedCount > 0) || congested) {
+        _limit = (NSUInteger) floor(_limit * _decreaseFactor);
+
+    } else if (bytesPerSecond > 0.0) {
+        _limit++;
+
+    }
+
+    _limit = MAX(_minLimit, MIN(_maxLimit, _limit));
+
+    if (bytesPerSecond > 0.0) {
+        if (_baselineBytesPerSecond <= 0.0) {
+            _baselineBytesPerSecond = bytesPerSecond;
+        } else {
+            _baselineBytesPerSecond = kBaselineSmoothing * bytesPerSecond + (1.0 - kBaselineSmoothing) * _baselineBytesPerSecond;
+        }
+    }
+
+    return _limit;
+}
+
+@end
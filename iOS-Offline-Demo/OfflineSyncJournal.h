@@ -0,0 +1,70 @@
+//
+//  OfflineSyncJournal.h
+//  iOS-Offline-Demo
+//
+//  Copyright © 2026 Feed Media. All rights reserved.
+//
+
+#import <Foundation/Foundation.h>
+#import <FeedMedia/FeedMedia.h>
+
+/**
+ A small on-disk record of which station downloads have been started
+ but not yet finished cleanly. If the app is killed in the middle of
+ a sync, the entry is still in the journal on the next launch, and
+ the `OfflineSyncQueue` uses it to put that station at the head of
+ the queue.
+
+ The journal also remembers the `identifier` and target minutes each
+ station had when it last finished downloading cleanly. Station
+ identifiers change whenever station contents change, so a matching
+ identifier means there is nothing new to fetch, as long as no more
+ music is being asked for than last time.
+
+ The file is read once, when the journal is created, and rewritten
+ in the background whenever a download starts or finishes.
+ */
+
+@interface OfflineSyncJournal : NSObject
+
+/**
+ * Journal stored in the app's Application Support directory.
+ */
+
++ (NSURL *) defaultJournalURL;
+
+- (instancetype) initWithURL:(NSURL *)url;
+
+/**
+ * Names of stations whose last download was interrupted or left
+ * failed files behind, oldest first.
+ */
+
+@property (nonatomic, readonly) NSArray<NSString *> *interruptedStationNames;
+
+/**
+ * The target minutes that were passed in when the station download
+ * was started, or nil if the server was left to decide.
+ */
+
+- (NSNumber *) targetMinutesForStationName:(NSString *)name;
+
+/**
+ * Returns YES if the last clean download of a station with this name
+ * was of a station with the same identifier, no more than `maxAge`
+ * seconds ago, and asked for at least `minutes`. A nil target stands
+ * for the server default, which only matches another nil target.
+ */
+
+- (BOOL) isStationUpToDate:(FMStation *)station targetMinutes:(NSNumber *)minutes maxAge:(NSTimeInterval)maxAge;
+
+- (void) recordStartOfStation:(FMStation *)station targetMinutes:(NSNumber *)minutes;
+
+/**
+ * Clears the station's entry if every file downloaded, otherwise
+ * leaves it so the station is retried on the next launch.
+ */
+
+- (void) recordCompletionOfStation:(FMStation *)station failedCount:(int)failedCount;
+
+@end
@@ -0,0 +1,154 @@
+//
+//  OfflineSyncJournal.m
+//  iOS-Offline-Demo
+//
+//  Copyright © 2026 Feed Media. All rights reserved.
+//
+
+#import "OfflineSyncJournal.h"
+
+static NSString *const kUnfinishedKey = @"unfinished";
+static NSString *const kSyncedKey = @"synced";
+
+static NSString *const kStartedKey = @"started";
+static NSString *const kTargetMinutesKey = @"targetMinutes";
+static NSString *const kIdentifierKey = @"identifier";
+static NSString *const kFinishedKey = @"finished";
+
+@implementation OfflineSyncJournal {
+
+    NSURL *_url;
+
+    // station name -> entry dictionary, for downloads not yet finished
+    NSMutableDictionary<NSString *, NSMutableDictionary *> *_entries;
+
+    // station name -> identifier, date and target minutes of the last clean download
+    NSMutableDictionary<NSString *, NSDictionary *> *_synced;
+
+    dispatch_queue_t _writeQueue;
+}
+
++ (NSURL *) defaultJournalURL {
+    NSURL *dir = [[NSFileManager defaultManager] URLsForDirectory:NSApplicationSupportDirectory inDomains:NSUserDomainMask].firstObject;
+
+    return [dir URLByAppendingPathComponent:@"offline-sync-journal.plist"];
+}
+
+- (instancetype) initWithURL:(NSURL *)url {
+    if (self = [super init]) {
+        _url = url;
+        _entries = [NSMutableDictionary dictionary];
+        _synced = [NSMutableDictionary dictionary];
+        _writeQueue = dispatch_queue_create("fm.offline.journal", DISPATCH_QUEUE_SERIAL);
+
+        NSDictionary *saved = [NSDictionary dictionaryWithContentsOfURL:url];
+
+        NSDictionary *unfinished = saved[kUnfinishedKey];
+        if ([unfinished isKindOfClass:[NSDictionary class]]) {
+            for (NSString *name in unfinished) {
+                if ([unfinished[name] isKindOfClass:[NSDictionary class]]) {
+                    _entries[name] = [unfinished[name] mutableCopy];
+                }
+            }
+        }
+
+        NSDictionary *synced = saved[kSyncedKey];
+        if ([synced isKindOfClass:[NSDictionary class]]) {
+            [_synced addEntriesFromDictionary:synced];
+        }
+
+        if (_entries.count > 0) {
+            NSLog(@"sync journal has %lu unfinished station downloads", (unsigned long) _entries.count);
+        }
+    }
+
+    return self;
+}
+
+- (NSArray<NSString *> *) interruptedStationNames {
+    return [_entries keysSortedByValueUsingComparator:^NSComparisonResult(NSDictionary *a, NSDictionary *b) {
+        return [a[kStartedKey] compare:b[kStartedKey]];
+    }];
+}
+
+- (NSNumber *) targetMinutesForStationName:(NSString *)name {
+    return _entries[name][kTargetMinutesKey];
+}
+
+- (BOOL) isStationUpToDate:(FMStation *)station targetMinutes:(NSNumber *)minutes maxAge:(NSTimeInterval)maxAge {
+    NSDictionary *last = _synced[station.name];
+
+    if ((last == nil) || (station.identifier == nil) || ![station.identifier isEqualToString:last[kIdentifierKey]]) {
+        return NO;
+    }
+
+    // we don't know what the server default is, so it can't be compared
+    // against an explicit target in either direction
+    NSNumber *lastMinutes = last[kTargetMinutesKey];
+    if ((minutes == nil) != (lastMinutes == nil)) {
+        return NO;
+    }
+
+    if ((minutes != nil) && (minutes.doubleValue > lastMinutes.doubleValue)) {
+        return NO;
+    }
+
+    return -[last[kFinishedKey] timeIntervalSinceNow] <= maxAge;
+}
+
+- (void) recordStartOfStation:(FMStation *)station targetMinutes:(NSNumber *)minutes {
+    NSMutableDictionary *entry = _entries[station.name];
+
+    if (entry == nil) {
+        entry = [NSMutableDictionary dictionary];
+        entry[kStartedKey] = [NSDate date];
+        _entries[station.name] = entry;
+    }
+
+    if (minutes != nil) {
+        entry[kTargetMinutesKey] = minutes;
+    } else {
+        [entry removeObjectForKey:kTargetMinutesKey];
+    }
+
+    [self save];
+}
+
+- (void) recordCompletionOfStation:(FMStation *)station failedCount:(int)failedCount {
+    // with failed files, the entry stays as it is so the station is retried next launch
+    if (failedCount > 0) {
+        return;
+    }
+
+    NSNumber *minutes = _entries[station.name][kTargetMinutesKey];
+    [_entries removeObjectForKey:station.name];
+
+    if (station.identifier != nil) {
+        NSMutableDictionary *synced = [@{ kIdentifierKey: station.identifier, kFinishedKey: [NSDate date] } mutableCopy];
+        if (minutes != nil) {
+            synced[kTargetMinutesKey] = minutes;
+        }
+
+        _synced[station.name] = synced;
+    }
+
+    [self save];
+}
+
+- (void) save {
+    NSDictionary *snapshot = @{
+        kUnfinishedKey: [[NSDictionary alloc] initWithDictionary:_entries copyItems:YES],
+        kSyncedKey: [_synced copy]
+    };
+    NSURL *url = _url;
+
+    dispatch_async(_writeQueue, ^{
+        [[NSFileManager defaultManager] createDirectoryAtURL:[url URLByDeletingLastPathComponent] withIntermediateDirectories:YES attributes:nil error:nil];
+
+        if (![snapshot writeToURL:url atomically:YES]) {
+            NSLog(@"**WARNING** unable to write sync journal to %@", url);
+        }
+    });
+}
+
+@end
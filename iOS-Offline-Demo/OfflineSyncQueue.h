@@ -0,0 +1,191 @@
+//
+//  OfflineSyncQueue.h
+//  iOS-Offline-Demo
+//
+//  Copyright © 2026 Feed Media. All rights reserved.
+//
+
+#import <Foundation/Foundation.h>
+#import <FeedMedia/FeedMedia.h>
+#import "OfflineSyncJournal.h"
+#import "OfflineDownloadProgress.h"
+#import "OfflineSyncConcurrencyController.h"
+
+@class OfflineSyncQueue;
+
+/**
+ Receives notice as stations queued with an `OfflineSyncQueue` are
+ downloaded. Progress events are passed straight through from the
+ SDK, while completion is only reported once a station has either
+ downloaded cleanly or run out of retries.
+ */
+
+@protocol OfflineSyncQueueDelegate <NSObject>
+
+/**
+ * Called once per queued station, after its final download attempt.
+ *
+ * @param queue the queue that downloaded the station
+ * @param station the station, as handed back by the SDK
+ * @param failedCount number of files that failed in the final attempt
+ */
+
+- (void) syncQueue:(OfflineSyncQueue *)queue didCompleteStation:(FMStation *)station failedCount:(int)failedCount;
+
+@optional
+
+/**
+ * Mirrors `[FMStationDownloadDelegate stationDownloadProgress:pendingCount:failedCount:totalCount:]`
+ * for every attempt made on a queued station.
+ */
+
+- (void) syncQueue:(OfflineSyncQueue *)queue
+   progressStation:(FMStation *)station
+      pendingCount:(int)pendingCount
+       failedCount:(int)failedCount
+        totalCount:(int)totalCount;
+
+/**
+ * Byte-level progress for a station download. Calls are coalesced so
+ * each station reports at most `maxProgressUpdatesPerSecond` times a
+ * second, but the final update for an attempt is always delivered.
+ */
+
+- (void) syncQueue:(OfflineSyncQueue *)queue didUpdateProgress:(OfflineDownloadProgress *)progress;
+
+@end
+
+/**
+ Runs `[FMAudioPlayer downloadAndSyncStation:forTargetMinutes:withDelegate:]`
+ for any number of stations, with at most `maxConcurrentDownloads`
+ stations in flight at once.
+
+ A station whose download finishes with failed files is put back
+ on the queue after an exponential backoff delay. The delay is
+ scheduled with a timer rather than by holding a slot, so the
+ remaining stations keep downloading while a failed one waits.
+
+ All methods must be called from the main thread, and all delegate
+ calls are made on the main thread.
+ */
+
+@interface OfflineSyncQueue : NSObject
+
+/**
+ * Maximum number of stations downloading at once. Defaults to 2.
+ */
+
+@property (nonatomic) NSUInteger maxConcurrentDownloads;
+
+/**
+ * When set, `maxConcurrentDownloads` is replaced with the controller's
+ * limit after every download attempt, based on the throughput and
+ * failures the attempt saw.
+ */
+
+@property (nonatomic, strong) OfflineSyncConcurrencyController *concurrencyController;
+
+/**
+ * Number of times a station with failed files is retried before
+ * it is reported as complete. Defaults to 3.
+ */
+
+@property (nonatomic) NSUInteger maxRetries;
+
+/**
+ * Delay before the first retry of a station. Each later retry
+ * doubles this. Defaults to 2 seconds.
+ */
+
+@property (nonatomic) NSTimeInterval initialRetryDelay;
+
+/**
+ * Upper bound on the delay between retries. Defaults to 60 seconds.
+ */
+
+@property (nonatomic) NSTimeInterval maxRetryDelay;
+
+/**
+ * Upper limit on `syncQueue:didUpdateProgress:` calls per station
+ * per second. Defaults to 4.
+ */
+
+@property (nonatomic) double maxProgressUpdatesPerSecond;
+
+@property (nonatomic, weak) id<OfflineSyncQueueDelegate> delegate;
+
+/**
+ * When set, every download started by this queue is recorded here
+ * until it finishes cleanly, so it can be resumed after an app restart.
+ */
+
+@property (nonatomic, strong) OfflineSyncJournal *journal;
+
+/**
+ * A station that the journal shows was last downloaded cleanly with the
+ * same `identifier` and at least the requested target minutes, less than
+ * this many seconds ago, and that is still in `localOfflineStationList`,
+ * is reported complete without contacting the server. Set to 0 to always sync. Defaults to one day, so stations
+ * still get a daily sync to swap out songs that have been heard.
+ */
+
+@property (nonatomic) NSTimeInterval resyncInterval;
+
+/**
+ * Number of stations that are downloading right now.
+ */
+
+@property (nonatomic, readonly) NSUInteger activeCount;
+
+/**
+ * Number of stations waiting for a free slot or for a retry.
+ */
+
+@property (nonatomic, readonly) NSUInteger pendingCount;
+
+/**
+ * Names of every station that is downloading, waiting for a slot,
+ * or waiting for a retry.
+ */
+
+@property (nonatomic, readonly) NSSet<NSString *> *queuedStationNames;
+
+- (instancetype) initWithPlayer:(FMAudioPlayer *)player;
+
+/**
+ * Queue the station for download, letting the server pick the
+ * target minutes. Stations already queued or downloading are ignored.
+ *
+ * @param station a station from remoteOfflineStationList or localOfflineStationList
+ */
+
+- (void) enqueueStation:(FMStation *)station;
+
+/**
+ * Queue the station for download with an explicit target.
+ *
+ * @param station a station from remoteOfflineStationList or localOfflineStationList
+ * @param minutes target minutes passed to the SDK, or nil to let the server decide
+ */
+
+- (void) enqueueStation:(FMStation *)station forTargetMinutes:(NSNumber *)minutes;
+
+/**
+ * Queue any of the given stations that the journal says were left
+ * unfinished by a previous run, ahead of everything else in the
+ * queue, with the target minutes they were originally started with.
+ * Does nothing when there is no journal.
+ *
+ * @param stations stations from remoteOfflineStationList
+ */
+
+- (void) enqueueInterruptedStations:(NSArray<FMStation *> *)stations;
+
+/**
+ * Drop every station that has not started downloading yet, including
+ * those waiting on a retry. Downloads already in flight run to completion.
+ */
+
+- (void) cancelPending;
+
+@end
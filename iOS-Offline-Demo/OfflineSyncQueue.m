@@ -0,0 +1,328 @@
+//
+//  OfflineSyncQueue.m
+//  iOS-Offline-Demo
+//
+//  Copyright © 2026 Feed Media. All rights reserved.
+//
+
+#import "OfflineSyncQueue.h"
+
+@interface OfflineSyncTask : NSObject <FMStationDownloadDelegate>
+
+@property (nonatomic, strong) FMStation *station;
+@property (nonatomic, strong) NSNumber *targetMinutes;
+@property (nonatomic) NSUInteger attempt;
+@property (nonatomic) int lastFailedCount;
+
+@property (nonatomic, strong) OfflineDownloadProgress *progress;
+@property (nonatomic) NSTimeInterval lastProgressDelivery;
+@property (nonatomic) BOOL progressDeliveryScheduled;
+
+@property (nonatomic, weak) OfflineSyncQueue *queue;
+
+@end
+
+@interface OfflineSyncQueue ()
+
+- (void) task:(OfflineSyncTask *)task progressStation:(FMStation *)station pendingCount:(int)pendingCount failedCount:(int)failedCount totalCount:(int)totalCount;
+- (void) task:(OfflineSyncTask *)task didCompleteStation:(FMStation *)station;
+
+@end
+
+@implementation OfflineSyncTask
+
+// Each download gets its own delegate object, so callbacks are routed
+// by identity rather than by matching up the FMStation the SDK hands back.
+
+- (void) stationDownloadProgress:(FMStation *)station pendingCount:(int)pendingCount failedCount:(int)failedCount totalCount:(int)totalCount {
+    _lastFailedCount = failedCount;
+
+    [_queue task:self progressStation:station pendingCount:pendingCount failedCount:failedCount totalCount:totalCount];
+}
+
+- (void) stationDownloadComplete:(FMStation *)station {
+    [_queue task:self didCompleteStation:station];
+}
+
+@end
+
+@implementation OfflineSyncQueue {
+
+    FMAudioPlayer *_player;
+
+    // waiting for a free slot, in order
+    NSMutableArray<OfflineSyncTask *> *_pending;
+
+    // waiting for a retry timer to fire
+    NSMutableArray<OfflineSyncTask *> *_backingOff;
+
+    // downloading now
+    NSMutableArray<OfflineSyncTask *> *_active;
+}
+
+- (instancetype) initWithPlayer:(FMAudioPlayer *)player {
+    if (self = [super init]) {
+        _player = player;
+        _pending = [NSMutableArray array];
+        _backingOff = [NSMutableArray array];
+        _active = [NSMutableArray array];
+
+        _maxConcurrentDownloads = 2;
+        _maxRetries = 3;
+        _initialRetryDelay = 2.0;
+        _maxRetryDelay = 60.0;
+        _resyncInterval = 24.0 * 60.0 * 60.0;
+        _maxProgressUpdatesPerSecond = 4.0;
+    }
+
+    return self;
+}
+
+- (NSUInteger) activeCount {
+    return _active.count;
+}
+
+- (NSUInteger) pendingCount {
+    return _pending.count + _backingOff.count;
+}
+
+- (NSSet<NSString *> *) queuedStationNames {
+    NSMutableSet *names = [NSMutableSet set];
+
+    for (NSArray *list in @[ _active, _pending, _backingOff ]) {
+        for (OfflineSyncTask *task in list) {
+            if (task.station.name != nil) {
+                [names addObject:task.station.name];
+            }
+        }
+    }
+
+    return names;
+}
+
+- (void) setMaxConcurrentDownloads:(NSUInteger)maxConcurrentDownloads {
+    _maxConcurrentDownloads = MAX(1, maxConcurrentDownloads);
+
+    [self startNext];
+}
+
+- (void) enqueueStation:(FMStation *)station {
+    [self enqueueStation:station forTargetMinutes:nil];
+}
+
+- (void) enqueueStation:(FMStation *)station forTargetMinutes:(NSNumber *)minutes {
+    if (station == nil) {
+        return;
+    }
+
+    if ([self taskForStation:station] != nil) {
+        return;
+    }
+
+    if ([self skipUpToDateStation:station targetMinutes:minutes]) {
+        return;
+    }
+
+    [_pending addObject:[self taskWithStation:station targetMinutes:minutes]];
+
+    [self startNext];
+}
+
+- (void) enqueueInterruptedStations:(NSArray<FMStation *> *)stations {
+    if (_journal == nil) {
+        return;
+    }
+
+    NSMutableArray *interrupted = [NSMutableArray array];
+
+    for (NSString *name in _journal.interruptedStationNames) {
+        for (FMStation *station in stations) {
+            if ([station.name isEqualToString:name] && ([self taskForStation:station] == nil)) {
+                [interrupted addObject:[self taskWithStation:station targetMinutes:[_journal targetMinutesForStationName:name]]];
+                break;
+            }
+        }
+    }
+
+    if (interrupted.count == 0) {
+        return;
+    }
+
+    NSLog(@"resuming %lu interrupted station downloads", (unsigned long) interrupted.count);
+
+    [_pending insertObjects:interrupted atIndexes:[NSIndexSet indexSetWithIndexesInRange:NSMakeRange(0, interrupted.count)]];
+
+    [self startNext];
+}
+
+- (BOOL) skipUpToDateStation:(FMStation *)station targetMinutes:(NSNumber *)minutes {
+    if ((_journal == nil) || (_resyncInterval <= 0.0) || ![_journal isStationUpToDate:station targetMinutes:minutes maxAge:_resyncInterval]) {
+        return NO;
+    }
+
+    FMStation *localStation = [_player.localOfflineStationList getStationWithName:station.name];
+    if (localStation == nil) {
+        return NO;
+    }
+
+    NSLog(@"station %@ is up to date, not syncing", station.name);
+
+    // report completion asynchronously, like a real download would
+    __weak OfflineSyncQueue *weakSelf = self;
+    dispatch_async(dispatch_get_main_queue(), ^{
+        OfflineSyncQueue *strongSelf = weakSelf;
+        [strongSelf.delegate syncQueue:strongSelf didCompleteStation:localStation failedCount:0];
+    });
+
+    return YES;
+}
+
+- (OfflineSyncTask *) taskWithStation:(FMStation *)station targetMinutes:(NSNumber *)minutes {
+    OfflineSyncTask *task = [[OfflineSyncTask alloc] init];
+    task.station = station;
+    task.targetMinutes = minutes;
+    task.queue = self;
+    task.progress = [[OfflineDownloadProgress alloc] initWithStation:station player:_player];
+
+    return task;
+}
+
+- (void) cancelPending {
+    [_pending removeAllObjects];
+    [_backingOff removeAllObjects];
+}
+
+- (OfflineSyncTask *) taskForStation:(FMStation *)station {
+    for (NSArray *list in @[ _active, _pending, _backingOff ]) {
+        for (OfflineSyncTask *task in list) {
+            if ([task.station.name isEqualToString:station.name]) {
+                return task;
+            }
+        }
+    }
+
+    return nil;
+}
+
+- (void) startNext {
+    while ((_active.count < _maxConcurrentDownloads) && (_pending.count > 0)) {
+        OfflineSyncTask *task = _pending[0];
+        [_pending removeObjectAtIndex:0];
+
+        task.attempt++;
+        task.lastFailedCount = 0;
+        [task.progress reset];
+        [_active addObject:task];
+
+        NSLog(@"starting download of station %@ (attempt %lu)", task.station.name, (unsigned long) task.attempt);
+
+        [_journal recordStartOfStation:task.station targetMinutes:task.targetMinutes];
+
+        if (task.targetMinutes != nil) {
+            [_player downloadAndSyncStation:task.station forTargetMinutes:task.targetMinutes withDelegate:task];
+        } else {
+            [_player downloadAndSyncStation:task.station withDelegate:task];
+        }
+    }
+}
+
+- (void) task:(OfflineSyncTask *)task progressStation:(FMStation *)station pendingCount:(int)pendingCount failedCount:(int)failedCount totalCount:(int)totalCount {
+    if ([_delegate respondsToSelector:@selector(syncQueue:progressStation:pendingCount:failedCount:totalCount:)]) {
+        [_delegate syncQueue:self progressStation:station pendingCount:pendingCount failedCount:failedCount totalCount:totalCount];
+    }
+
+    [task.progress updateWithPendingCount:pendingCount failedCount:failedCount totalCount:totalCount];
+
+    if ([_delegate respondsToSelector:@selector(syncQueue:didUpdateProgress:)]) {
+        [self deliverProgressForTask:task];
+    }
+}
+
+- (void) deliverProgressForTask:(OfflineSyncTask *)task {
+    NSTimeInterval now = [NSDate timeIntervalSinceReferenceDate];
+    NSTimeInterval minInterval = (_maxProgressUpdatesPerSecond > 0.0) ? (1.0 / _maxProgressUpdatesPerSecond) : 0.0;
+    NSTimeInterval wait = task.lastProgressDelivery + minInterval - now;
+
+    if (task.progress.isFinished || (wait <= 0.0)) {
+        task.lastProgressDelivery = now;
+        [_delegate syncQueue:self didUpdateProgress:task.progress];
+        return;
+    }
+
+    // one trailing call picks up whatever the latest state is by then
+    if (task.progressDeliveryScheduled) {
+        return;
+    }
+
+    task.progressDeliveryScheduled = YES;
+
+    __weak OfflineSyncQueue *weakSelf = self;
+    dispatch_after(dispatch_time(DISPATCH_TIME_NOW, (int64_t) (wait * NSEC_PER_SEC)), dispatch_get_main_queue(), ^{
+        OfflineSyncQueue *strongSelf = weakSelf;
+
+        task.progressDeliveryScheduled = NO;
+
+        // the final update may have gone out already
+        if ((strongSelf == nil) || task.progress.isFinished) {
+            return;
+        }
+
+        task.lastProgressDelivery = [NSDate timeIntervalSinceReferenceDate];
+        [strongSelf.delegate syncQueue:strongSelf didUpdateProgress:task.progress];
+    });
+}
+
+- (void) task:(OfflineSyncTask *)task didCompleteStation:(FMStation *)station {
+    if (![_active containsObject:task]) {
+        return;
+    }
+
+    [_active removeObject:task];
+
+    if (_concurrencyController != nil) {
+        NSUInteger limit = [_concurrencyController recordAttemptWithBytesPerSecond:task.progress.bytesPerSecond failedCount:task.lastFailedCount];
+
+        if (limit != _maxConcurrentDownloads) {
+            NSLog(@"adjusting concurrent station downloads from %lu to %lu", (unsigned long) _maxConcurrentDownloads, (unsigned long) limit);
+            self.maxConcurrentDownloads = limit;
+        }
+    }
+
+    if ((task.lastFailedCount > 0) && (task.attempt <= _maxRetries)) {
+        [self scheduleRetry:task];
+
+    } else {
+        [_journal recordCompletionOfStation:task.station failedCount:task.lastFailedCount];
+        [_delegate syncQueue:self didCompleteStation:station failedCount:task.lastFailedCount];
+
+    }
+
+    [self startNext];
+}
+
+- (void) scheduleRetry:(OfflineSyncTask *)task {
+    NSTimeInterval delay = MIN(_maxRetryDelay, _initialRetryDelay * pow(2.0, (double) (task.attempt - 1)));
+
+    NSLog(@"station %@ had %d failed files, retrying in %.1f seconds", task.station.name, task.lastFailedCount, delay);
+
+    [_backingOff addObject:task];
+
+    __weak OfflineSyncQueue *weakSelf = self;
+    dispatch_after(dispatch_time(DISPATCH_TIME_NOW, (int64_t) (delay * NSEC_PER_SEC)), dispatch_get_main_queue(), ^{
+        [weakSelf retryTask:task];
+    });
+}
+
+- (void) retryTask:(OfflineSyncTask *)task {
+    // cancelPending may have dropped this while we waited
+    if (![_backingOff containsObject:task]) {
+        return;
+    }
+
+    [_backingOff removeObject:task];
+    [_pending addObject:task];
+
+    [self startNext];
+}
+
+@end
@@ -0,0 +1,75 @@
+//
+//  PlayHistoryLog.h
+//  iOS-Offline-Demo
+//
+//  Copyright © 2026 Feed Media. All rights reserved.
+//
+
+#import <Foundation/Foundation.h>
+#import <FeedMedia/FeedMedia.h>
+
+/**
+ Keeps `[FMAudioPlayer playHistory]` from growing without bound in
+ long-running sessions.
+
+ Every time a song starts, a compact record of it (time, item id,
+ name, artist, album and station name) is appended to a log file, one
+ JSON object per line. `playHistory` is then trimmed to the most
+ recent `capacity` items, so it still gives random access to recent
+ plays without keeping every `FMAudioItem` alive. Older plays can be
+ read back from the log with `recordAtIndex:completion:`.
+
+ The log keeps at most around `maxLogRecords` plays. Once it grows a
+ quarter past that, it is rewritten with only the most recent
+ `maxLogRecords` records, so neither the file nor the in-memory index
+ grows without bound.
+
+ All file access happens on a background queue, and only the file
+ offset of each record is kept in memory. Reads are asynchronous so
+ they never stall the main thread behind a write.
+ */
+
+@interface PlayHistoryLog : NSObject
+
+/**
+ * Most items left in `playHistory`. Defaults to 50.
+ */
+
+@property (nonatomic) NSUInteger capacity;
+
+/**
+ * Most plays kept in the log once it is compacted. Defaults to 1000.
+ */
+
+@property (nonatomic) NSUInteger maxLogRecords;
+
++ (NSURL *) defaultLogURL;
+
+/**
+ * Start logging plays. The log is appended to if it already exists.
+ */
+
+- (instancetype) initWithPlayer:(FMAudioPlayer *)player logURL:(NSURL *)url;
+
+/**
+ * Count the plays currently held in the log.
+ *
+ * @param completion called on the main queue with the number of records
+ */
+
+- (void) recordCountWithCompletion:(void (^)(NSUInteger count))completion;
+
+/**
+ * Read a play record back from the log. Index 0 is the oldest record
+ * still in the log, and `count - 1` the most recent. These indexes are
+ * unrelated to `playHistory` indexes, and shift down whenever the log
+ * is compacted.
+ *
+ * @param completion called on the main queue with a dictionary holding
+ *   "time", "id", "name", "artist", "album" and "station" keys, or nil
+ *   if the index is out of range
+ */
+
+- (void) recordAtIndex:(NSUInteger)index completion:(void (^)(NSDictionary *record))completion;
+
+@end
@@ -0,0 +1,224 @@
+//
+//  PlayHistoryLog.m
+//  iOS-Offline-Demo
+//
+//  Copyright © 2026 Feed Media. All rights reserved.
+//
+
+#import "PlayHistoryLog.h"
+
+@implementation PlayHistoryLog {
+
+    FMAudioPlayer *_player;
+    NSURL *_url;
+
+    // byte offset of each record in the log; touched only on _logQueue
+    NSMutableData *_offsets;
+    unsigned long long _logLength;
+
+    dispatch_queue_t _logQueue;
+}
+
++ (NSURL *) defaultLogURL {
+    NSURL *dir = [[NSFileManager defaultManager] URLsForDirectory:NSApplicationSupportDirectory inDomains:NSUserDomainMask].firstObject;
+
+    return [dir URLByAppendingPathComponent:@"play-history.log"];
+}
+
+- (instancetype) initWithPlayer:(FMAudioPlayer *)player logURL:(NSURL *)url {
+    if (self = [super init]) {
+        _player = player;
+        _url = url;
+        _capacity = 50;
+        _maxLogRecords = 1000;
+        _offsets = [NSMutableData data];
+        _logQueue = dispatch_queue_create("fm.playhistory.log", DISPATCH_QUEUE_SERIAL);
+
+        NSUInteger maxLogRecords = _maxLogRecords;
+        dispatch_async(_logQueue, ^{
+            [self indexExistingLog];
+            [self compactIfNeededKeepingRecords:maxLogRecords];
+        });
+
+        [[NSNotificationCenter defaultCenter] addObserver:self selector:@selector(itemStarted:) name:FMAudioPlayerCurrentItemDidBeginPlaybackNotification object:_player];
+    }
+
+    return self;
+}
+
+- (void) dealloc {
+    [[NSNotificationCenter defaultCenter] removeObserver:self];
+}
+
+- (void) setCapacity:(NSUInteger)capacity {
+    _capacity = MAX(1, capacity);
+
+    [self trimHistory];
+}
+
+- (void) setMaxLogRecords:(NSUInteger)maxLogRecords {
+    _maxLogRecords = MAX(1, maxLogRecords);
+
+    NSUInteger keep = _maxLogRecords;
+    dispatch_async(_logQueue, ^{
+        [self compactIfNeededKeepingRecords:keep];
+    });
+}
+
+- (void) recordCountWithCompletion:(void (^)(NSUInteger count))completion {
+    dispatch_async(_logQueue, ^{
+        NSUInteger count = self->_offsets.length / sizeof(unsigned long long);
+
+        dispatch_async(dispatch_get_main_queue(), ^{
+            completion(count);
+        });
+    });
+}
+
+- (void) indexExistingLog {
+    NSData *data = [NSData dataWithContentsOfURL:_url options:NSDataReadingMappedIfSafe error:nil];
+    const char *bytes = data.bytes;
+    const char *end = bytes + data.length;
+    const char *start = bytes;
+    const char *newline;
+
+    while ((start < end) && ((newline = memchr(start, '\n', end - start)) != NULL)) {
+        unsigned long long offset = start - bytes;
+        [_offsets appendBytes:&offset length:sizeof(offset)];
+        start = newline + 1;
+    }
+
+    // anything after the last newline is a record cut off by a crash; it
+    // gets overwritten by the next append
+    _logLength = start - bytes;
+}
+
+- (void) compactIfNeededKeepingRecords:(NSUInteger)keep {
+    NSUInteger count = _offsets.length / sizeof(unsigned long long);
+
+    // let the log run a little over, so we rewrite it every few hundred
+    // plays rather than on every one
+    if (count <= keep + keep / 4) {
+        return;
+    }
+
+    const unsigned long long *offsets = _offsets.bytes;
+    unsigned long long base = offsets[count - keep];
+
+    NSData *data = [NSData dataWithContentsOfURL:_url options:NSDataReadingMappedIfSafe error:nil];
+    if (data.length < _logLength) {
+        NSLog(@"**WARNING** play history log at %@ is shorter than expected, not compacting", _url);
+        return;
+    }
+
+    NSError *error = nil;
+    NSData *kept = [data subdataWithRange:NSMakeRange((NSUInteger) base, (NSUInteger) (_logLength - base))];
+    if (![kept writeToURL:_url options:NSDataWritingAtomic error:&error]) {
+        NSLog(@"**WARNING** unable to compact play history log: %@", error);
+        return;
+    }
+
+    NSMutableData *rebased = [NSMutableData dataWithLength:keep * sizeof(unsigned long long)];
+    unsigned long long *newOffsets = rebased.mutableBytes;
+    for (NSUInteger i = 0; i < keep; i++) {
+        newOffsets[i] = offsets[count - keep + i] - base;
+    }
+
+    _offsets = rebased;
+    _logLength -= base;
+}
+
+- (void) itemStarted:(NSNotification *)notification {
+    FMAudioItem *item = _player.currentItem;
+
+    if (item != nil) {
+        NSDictionary *record = @{
+            @"time": @([[NSDate date] timeIntervalSince1970]),
+            @"id": item.id ?: @"",
+            @"name": item.name ?: @"",
+            @"artist": item.artist ?: @"",
+            @"album": item.album ?: @"",
+            @"station": item.station.name ?: (_player.activeStation.name ?: @"")
+        };
+
+        NSUInteger maxLogRecords = _maxLogRecords;
+        dispatch_async(_logQueue, ^{
+            [self appendRecord:record];
+            [self compactIfNeededKeepingRecords:maxLogRecords];
+        });
+    }
+
+    [self trimHistory];
+}
+
+- (void) trimHistory {
+    NSMutableArray *history = _player.playHistory;
+
+    if (history.count > _capacity) {
+        [history removeObjectsInRange:NSMakeRange(0, history.count - _capacity)];
+    }
+}
+
+- (void) appendRecord:(NSDictionary *)record {
+    NSMutableData *line = [[NSJSONSerialization dataWithJSONObject:record options:0 error:nil] mutableCopy];
+    if (line == nil) {
+        return;
+    }
+
+    [line appendBytes:"\n" length:1];
+
+    NSFileManager *fm = [NSFileManager defaultManager];
+    if (![fm fileExistsAtPath:_url.path]) {
+        [fm createDirectoryAtURL:[_url URLByDeletingLastPathComponent] withIntermediateDirectories:YES attributes:nil error:nil];
+        [fm createFileAtPath:_url.path contents:nil attributes:nil];
+    }
+
+    NSFileHandle *handle = [NSFileHandle fileHandleForWritingToURL:_url error:nil];
+    if (handle == nil) {
+        NSLog(@"**WARNING** unable to open play history log at %@", _url);
+        return;
+    }
+
+    [handle seekToFileOffset:_logLength];
+    [handle writeData:line];
+    [handle truncateFileAtOffset:_logLength + line.length];
+    [handle closeFile];
+
+    unsigned long long offset = _logLength;
+    [_offsets appendBytes:&offset length:sizeof(offset)];
+    _logLength += line.length;
+}
+
+- (void) recordAtIndex:(NSUInteger)index completion:(void (^)(NSDictionary *record))completion {
+    dispatch_async(_logQueue, ^{
+        NSDictionary *record = [self readRecordAtIndex:index];
+
+        dispatch_async(dispatch_get_main_queue(), ^{
+            completion(record);
+        });
+    });
+}
+
+- (NSDictionary *) readRecordAtIndex:(NSUInteger)index {
+    NSUInteger count = _offsets.length / sizeof(unsigned long long);
+    if (index >= count) {
+        return nil;
+    }
+
+    const unsigned long long *offsets = _offsets.bytes;
+    unsigned long long start = offsets[index];
+    unsigned long long end = (index + 1 < count) ? offsets[index + 1] : _logLength;
+
+    NSFileHandle *handle = [NSFileHandle fileHandleForReadingFromURL:_url error:nil];
+    [handle seekToFileOffset:start];
+    NSData *line = [handle readDataOfLength:(NSUInteger) (end - start)];
+    [handle closeFile];
+
+    if (line.length == 0) {
+        return nil;
+    }
+
+    return [NSJSONSerialization JSONObjectWithData:line options:0 error:nil];
+}
+
+@end
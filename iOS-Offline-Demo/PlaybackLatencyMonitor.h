@@ -0,0 +1,96 @@
+//
+//  PlaybackLatencyMonitor.h
+//  iOS-Offline-Demo
+//
+//  Copyright © 2026 Feed Media. All rights reserved.
+//
+
+#import <Foundation/Foundation.h>
+#import <FeedMedia/FeedMedia.h>
+
+/**
+ Measures how long the player takes to produce audio after the app
+ asks for it.
+
+ Call `noteStartRequested` right before calling `[FMAudioPlayer play]`.
+ The time until the next `FMAudioPlayerCurrentItemDidBeginPlaybackNotification`
+ is recorded as time-to-first-audio. Requests made while a song is
+ already playing or paused are ignored, because those resume a song
+ rather than start one.
+
+ The monitor also times skips, from the skip request to the first
+ audio of the next song, into a histogram. Skips are picked up
+ automatically when the player enters
+ `FMAudioPlayerPlaybackStateRequestingSkip`. That covers lock screen
+ and UI library skips. Call `noteSkipRequested` before `[FMAudioPlayer skip]`
+ to start the clock a little earlier. Skips the server rejects are
+ not counted.
+
+ A request that goes nowhere mustn't be charged to the next song that
+ happens to start minutes later. So a pending start or skip is dropped
+ in three cases:
+ - the player reaches `FMAudioPlayerPlaybackStateComplete` or
+   `FMAudioPlayerPlaybackStateUnavailable`
+ - a pending skip sees the player go back to playing the song it was
+   meant to skip
+ - a sample is older than `maxRequestAge`
+ */
+
+@interface PlaybackLatencyMonitor : NSObject
+
+/**
+ * Most recent time-to-first-audio, in seconds, or -1 if none has
+ * been measured.
+ */
+
+@property (nonatomic, readonly) NSTimeInterval lastTimeToFirstAudio;
+
+/**
+ * Number of time-to-first-audio measurements taken.
+ */
+
+@property (nonatomic, readonly) NSUInteger timeToFirstAudioCount;
+
+/**
+ * Mean and worst time-to-first-audio, in seconds.
+ */
+
+@property (nonatomic, readonly) NSTimeInterval meanTimeToFirstAudio;
+@property (nonatomic, readonly) NSTimeInterval maxTimeToFirstAudio;
+
+/**
+ * Upper bounds, in milliseconds, of the skip latency histogram buckets.
+ * A final bucket holds everything slower than the last bound.
+ */
+
++ (NSArray<NSNumber *> *) skipLatencyBucketBounds;
+
+/**
+ * Count of skips in each bucket. Has one more entry than
+ * `skipLatencyBucketBounds`.
+ */
+
+@property (nonatomic, readonly) NSArray<NSNumber *> *skipLatencyHistogram;
+
+@property (nonatomic, readonly) NSUInteger skipCount;
+
+/**
+ * Starts and skips that take longer than this many seconds are assumed
+ * to have been dropped by the player, and aren't recorded. Defaults to 30.
+ */
+
+@property (nonatomic) NSTimeInterval maxRequestAge;
+
+- (instancetype) initWithPlayer:(FMAudioPlayer *)player;
+
+- (void) noteStartRequested;
+
+- (void) noteSkipRequested;
+
+/**
+ * One-line summary of the skip histogram, for logging.
+ */
+
+- (NSString *) skipLatencySummary;
+
+@end
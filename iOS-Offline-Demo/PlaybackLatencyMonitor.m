@@ -0,0 +1,187 @@
+//
+//  PlaybackLatencyMonitor.m
+//  iOS-Offline-Demo
+//
+//  Copyright © 2026 Feed Media. All rights reserved.
+//
+
+#import "PlaybackLatencyMonitor.h"
+
+#define kSkipBucketCount 8
+
+@implementation PlaybackLatencyMonitor {
+
+    FMAudioPlayer *_player;
+
+    // when the pending start was requested, or 0 if nothing is pending
+    NSTimeInterval _startRequestedAt;
+
+    NSTimeInterval _totalTimeToFirstAudio;
+
+    // when the pending skip was requested, or 0 if nothing is pending
+    NSTimeInterval _skipRequestedAt;
+
+    // the song that was playing when the pending skip was requested
+    FMAudioItem *_skipRequestedItem;
+
+    // one more bucket than there are bounds
+    NSUInteger _skipBuckets[kSkipBucketCount + 1];
+}
+
++ (NSArray<NSNumber *> *) skipLatencyBucketBounds {
+    static NSArray *bounds;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        bounds = @[ @25, @50, @100, @250, @500, @1000, @2000, @5000 ];
+    });
+
+    return bounds;
+}
+
+- (instancetype) initWithPlayer:(FMAudioPlayer *)player {
+    if (self = [super init]) {
+        _player = player;
+        _lastTimeToFirstAudio = -1.0;
+        _maxRequestAge = 30.0;
+
+        [[NSNotificationCenter defaultCenter] addObserver:self selector:@selector(itemStarted:) name:FMAudioPlayerCurrentItemDidBeginPlaybackNotification object:_player];
+        [[NSNotificationCenter defaultCenter] addObserver:self selector:@selector(stateChanged:) name:FMAudioPlayerPlaybackStateDidChangeNotification object:_player];
+        [[NSNotificationCenter defaultCenter] addObserver:self selector:@selector(skipFailed:) name:FMAudioPlayerSkipFailedNotification object:_player];
+    }
+
+    return self;
+}
+
+- (void) dealloc {
+    [[NSNotificationCenter defaultCenter] removeObserver:self];
+}
+
+- (NSTimeInterval) meanTimeToFirstAudio {
+    return (_timeToFirstAudioCount > 0) ? (_totalTimeToFirstAudio / _timeToFirstAudioCount) : 0.0;
+}
+
+- (void) noteStartRequested {
+    FMAudioPlayerPlaybackState state = _player.playbackState;
+
+    if ((state == FMAudioPlayerPlaybackStatePlaying) || (state == FMAudioPlayerPlaybackStatePaused)) {
+        return;
+    }
+
+    _startRequestedAt = [NSDate timeIntervalSinceReferenceDate];
+}
+
+- (void) noteSkipRequested {
+    _skipRequestedAt = [NSDate timeIntervalSinceReferenceDate];
+    _skipRequestedItem = _player.currentItem;
+}
+
+- (void) stateChanged:(NSNotification *)notification {
+    FMAudioPlayerPlaybackState state = _player.playbackState;
+
+    if ((state == FMAudioPlayerPlaybackStateRequestingSkip) && (_skipRequestedAt == 0.0)) {
+        [self noteSkipRequested];
+    }
+
+    // nothing more is going to play, so whatever we were waiting for isn't coming
+    if ((state == FMAudioPlayerPlaybackStateComplete) || (state == FMAudioPlayerPlaybackStateUnavailable)) {
+        _startRequestedAt = 0.0;
+        [self clearPendingSkip];
+    }
+
+    // still playing the song we asked to skip, so the skip didn't happen
+    if ((state == FMAudioPlayerPlaybackStatePlaying) && (_skipRequestedAt != 0.0) && (_skipRequestedItem != nil) && (_player.currentItem == _skipRequestedItem)) {
+        [self clearPendingSkip];
+    }
+}
+
+- (void) skipFailed:(NSNotification *)notification {
+    [self clearPendingSkip];
+}
+
+- (void) clearPendingSkip {
+    _skipRequestedAt = 0.0;
+    _skipRequestedItem = nil;
+}
+
+- (NSUInteger) skipCount {
+    NSUInteger count = 0;
+
+    for (int i = 0; i <= kSkipBucketCount; i++) {
+        count += _skipBuckets[i];
+    }
+
+    return count;
+}
+
+- (NSArray<NSNumber *> *) skipLatencyHistogram {
+    NSMutableArray *counts = [NSMutableArray arrayWithCapacity:kSkipBucketCount + 1];
+
+    for (int i = 0; i <= kSkipBucketCount; i++) {
+        [counts addObject:@(_skipBuckets[i])];
+    }
+
+    return counts;
+}
+
+- (NSString *) skipLatencySummary {
+    NSArray *bounds = [PlaybackLatencyMonitor skipLatencyBucketBounds];
+    NSMutableArray *parts = [NSMutableArray array];
+
+    for (int i = 0; i <= kSkipBucketCount; i++) {
+        NSString *label = (i < kSkipBucketCount) ? [NSString stringWithFormat:@"<%@ms", bounds[i]] : [NSString stringWithFormat:@">=%@ms", bounds.lastObject];
+
+        [parts addObject:[NSString stringWithFormat:@"%@: %lu", label, (unsigned long) _skipBuckets[i]]];
+    }
+
+    return [parts componentsJoinedByString:@", "];
+}
+
+- (void) recordSkipLatency:(NSTimeInterval)latency {
+    NSArray *bounds = [PlaybackLatencyMonitor skipLatencyBucketBounds];
+    double ms = latency * 1000.0;
+
+    int bucket = 0;
+    while ((bucket < kSkipBucketCount) && (ms >= [bounds[bucket] doubleValue])) {
+        bucket++;
+    }
+
+    _skipBuckets[bucket]++;
+
+    NSLog(@"skip latency: %.0fms (%@)", ms, [self skipLatencySummary]);
+}
+
+- (void) itemStarted:(NSNotification *)notification {
+    NSTimeInterval now = [NSDate timeIntervalSinceReferenceDate];
+
+    if (_skipRequestedAt != 0.0) {
+        NSTimeInterval latency = now - _skipRequestedAt;
+        [self clearPendingSkip];
+
+        if (latency <= _maxRequestAge) {
+            [self recordSkipLatency:latency];
+        } else {
+            NSLog(@"ignoring skip requested %.0f seconds before the next song started", latency);
+        }
+    }
+
+    if (_startRequestedAt == 0.0) {
+        return;
+    }
+
+    NSTimeInterval latency = now - _startRequestedAt;
+    _startRequestedAt = 0.0;
+
+    if (latency > _maxRequestAge) {
+        NSLog(@"ignoring start requested %.0f seconds before the first song started", latency);
+        return;
+    }
+
+    _lastTimeToFirstAudio = latency;
+    _totalTimeToFirstAudio += latency;
+    _maxTimeToFirstAudio = MAX(_maxTimeToFirstAudio, latency);
+    _timeToFirstAudioCount++;
+
+    NSLog(@"time to first audio: %.0fms (mean %.0fms over %lu starts)", latency * 1000.0, self.meanTimeToFirstAudio * 1000.0, (unsigned long) _timeToFirstAudioCount);
+}
+
+@end